@@ -0,0 +1,117 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares default and performance-tuned engine builds on numeric,
+// string-heavy and JSON-heavy workloads, and on native call errors.
+// Run it with the Duktape engine once with "wilton_duktape" library
+// and once with "wilton_duktape_perf" deployed in its place, results
+// are printed as JSON with the best of "rounds" timings in millis.
+
+define(function() {
+    "use strict";
+
+    var rounds = 5;
+
+    function measure(name, iterations, fun) {
+        var best = -1;
+        var check = null;
+        for (var r = 0; r < rounds; r++) {
+            var start = Date.now();
+            check = fun(iterations);
+            var elapsed = Date.now() - start;
+            if (best < 0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        return {
+            name: name,
+            iterations: iterations,
+            bestMillis: best,
+            // printed to make sure that work is not skipped
+            check: check
+        };
+    }
+
+    function numeric(iterations) {
+        var sieve = [];
+        var primes = 0;
+        for (var i = 2; i < iterations; i++) {
+            if (!sieve[i]) {
+                primes += 1;
+                for (var j = i * 2; j < iterations; j += i) {
+                    sieve[j] = true;
+                }
+            }
+        }
+        var acc = 0;
+        for (var k = 1; k < iterations; k++) {
+            acc += Math.sqrt(k) * 1.5 / k;
+        }
+        return primes + Math.floor(acc);
+    }
+
+    function strings(iterations) {
+        var res = 0;
+        for (var i = 0; i < iterations; i++) {
+            var str = "item_" + i + "_" + (i * 7) + "_suffix";
+            var parts = str.split("_");
+            var joined = parts.join("-").replace(/-/g, ":").toUpperCase();
+            res += joined.indexOf("SUFFIX") + joined.charCodeAt(i % joined.length);
+        }
+        return res;
+    }
+
+    function json(iterations) {
+        var obj = {
+            id: 42,
+            name: "benchmark",
+            tags: ["a", "b", "c", "d"],
+            nested: { flag: true, values: [1.5, 2.5, 3.5], text: "some longer text value" }
+        };
+        var res = 0;
+        for (var i = 0; i < iterations; i++) {
+            obj.id = i;
+            var str = JSON.stringify(obj);
+            var parsed = JSON.parse(str);
+            res += parsed.id + parsed.nested.values.length + str.length;
+        }
+        return res;
+    }
+
+    // each failure crosses the native boundary and is thrown as a JS error
+    function nativeErrors(iterations) {
+        var caught = 0;
+        for (var i = 0; i < iterations; i++) {
+            try {
+                WILTON_wiltoncall("benchmark_missing_call_name", "{}");
+            } catch (e) {
+                caught += 1;
+            }
+        }
+        return caught;
+    }
+
+    return {
+        main: function() {
+            print(JSON.stringify([
+                measure("numeric", 200000, numeric),
+                measure("strings", 50000, strings),
+                measure("json", 20000, json),
+                measure("nativeErrors", 20000, nativeErrors)
+            ], null, 4));
+        }
+    };
+});
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares native text, builder, codec and hash primitives with their
+// pure JS equivalents on the same inputs, both variants are checked
+// to produce the same results before timing. Run it with the Duktape
+// engine, results are printed as JSON with the best of "rounds" timings
+// in millis for the native and JS variants.
+
+define(function() {
+    "use strict";
+
+    var rounds = 5;
+    var hexChars = "0123456789abcdef";
+    var b64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    function best(iterations, fun) {
+        var res = -1;
+        for (var r = 0; r < rounds; r++) {
+            var start = Date.now();
+            for (var i = 0; i < iterations; i++) {
+                fun(i);
+            }
+            var elapsed = Date.now() - start;
+            if (res < 0 || elapsed < res) {
+                res = elapsed;
+            }
+        }
+        return res;
+    }
+
+    function compare(name, iterations, nativeFun, jsFun) {
+        var expected = nativeFun(0);
+        var actual = jsFun(0);
+        if (String(expected) !== String(actual)) {
+            throw new Error("Results mismatch, benchmark: [" + name + "]," +
+                    " native: [" + expected + "], js: [" + actual + "]");
+        }
+        var nativeMillis = best(iterations, nativeFun);
+        var jsMillis = best(iterations, jsFun);
+        return {
+            name: name,
+            iterations: iterations,
+            nativeMillis: nativeMillis,
+            jsMillis: jsMillis,
+            speedup: nativeMillis > 0 ? Math.round(jsMillis / nativeMillis * 100) / 100 : null
+        };
+    }
+
+    function makeText(len) {
+        var parts = [];
+        for (var i = 0; i < len; i++) {
+            // ASCII with some 2 and 3 byte UTF-8 characters
+            parts.push(0 === i % 16 ? "é" : 0 === i % 37 ? "中" : String.fromCharCode(97 + i % 26));
+        }
+        return parts.join("");
+    }
+
+    // JS equivalents
+
+    function jsUtf8Encode(str) {
+        var bin = unescape(encodeURIComponent(str));
+        var res = [];
+        for (var i = 0; i < bin.length; i++) {
+            res.push(bin.charCodeAt(i));
+        }
+        return res;
+    }
+
+    function jsHexEncode(bytes) {
+        var res = [];
+        for (var i = 0; i < bytes.length; i++) {
+            res.push(hexChars.charAt(bytes[i] >> 4) + hexChars.charAt(bytes[i] & 0x0f));
+        }
+        return res.join("");
+    }
+
+    function jsHexDecode(hex) {
+        var res = [];
+        for (var i = 0; i < hex.length; i += 2) {
+            res.push(parseInt(hex.substr(i, 2), 16));
+        }
+        return res;
+    }
+
+    function jsBase64Encode(bytes) {
+        var res = [];
+        for (var i = 0; i < bytes.length; i += 3) {
+            var b0 = bytes[i];
+            var b1 = i + 1 < bytes.length ? bytes[i + 1] : 0;
+            var b2 = i + 2 < bytes.length ? bytes[i + 2] : 0;
+            res.push(b64Chars.charAt(b0 >> 2));
+            res.push(b64Chars.charAt(((b0 & 3) << 4) | (b1 >> 4)));
+            res.push(i + 1 < bytes.length ? b64Chars.charAt(((b1 & 15) << 2) | (b2 >> 6)) : "=");
+            res.push(i + 2 < bytes.length ? b64Chars.charAt(b2 & 63) : "=");
+        }
+        return res.join("");
+    }
+
+    function jsBase64Decode(str) {
+        var res = [];
+        for (var i = 0; i < str.length; i += 4) {
+            var c0 = b64Chars.indexOf(str.charAt(i));
+            var c1 = b64Chars.indexOf(str.charAt(i + 1));
+            var c2 = b64Chars.indexOf(str.charAt(i + 2));
+            var c3 = b64Chars.indexOf(str.charAt(i + 3));
+            res.push((c0 << 2) | (c1 >> 4));
+            if (c2 >= 0) {
+                res.push(((c1 & 15) << 4) | (c2 >> 2));
+            }
+            if (c3 >= 0) {
+                res.push(((c2 & 3) << 6) | c3);
+            }
+        }
+        return res;
+    }
+
+    var crcTable = (function() {
+        var table = [];
+        for (var n = 0; n < 256; n++) {
+            var c = n;
+            for (var k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xedb88320 ^ (c >>> 1)) : (c >>> 1);
+            }
+            table.push(c >>> 0);
+        }
+        return table;
+    })();
+
+    function jsCrc32(bytes) {
+        var crc = 0xffffffff;
+        for (var i = 0; i < bytes.length; i++) {
+            crc = crcTable[(crc ^ bytes[i]) & 0xff] ^ (crc >>> 8);
+        }
+        return (crc ^ 0xffffffff) >>> 0;
+    }
+
+    function jsFnv1a32(bytes) {
+        var hash = 0x811c9dc5;
+        for (var i = 0; i < bytes.length; i++) {
+            hash ^= bytes[i];
+            // multiplication by FNV prime 16777619 split to stay within 2^53
+            hash = (hash + (hash << 1) + (hash << 4) + (hash << 7) + (hash << 8) + (hash << 24)) >>> 0;
+        }
+        return hash >>> 0;
+    }
+
+    function toArray(buf) {
+        var res = [];
+        for (var i = 0; i < buf.length; i++) {
+            res.push(buf[i]);
+        }
+        return res;
+    }
+
+    return {
+        main: function() {
+            var text = makeText(4096);
+            var bytes = jsUtf8Encode(text);
+            var buf = new TextEncoder().encode(text);
+            var hex = WILTON_hex_encode(buf);
+            var b64 = WILTON_base64_encode(buf);
+            var encoder = new TextEncoder();
+            var results = [
+                compare("utf8Encode", 2000, function() {
+                    return toArray(encoder.encode(text)).length;
+                }, function() {
+                    return jsUtf8Encode(text).length;
+                }),
+                compare("stringBuilder", 200, function() {
+                    var sb = new StringBuilder();
+                    for (var i = 0; i < 1000; i++) {
+                        sb.append("line ").append(String(i)).append("\n");
+                    }
+                    return sb.toString().length;
+                }, function() {
+                    var str = "";
+                    for (var i = 0; i < 1000; i++) {
+                        str += "line " + i + "\n";
+                    }
+                    return str.length;
+                }),
+                compare("hexEncode", 2000, function() {
+                    return WILTON_hex_encode(buf);
+                }, function() {
+                    return jsHexEncode(bytes);
+                }),
+                compare("hexDecode", 2000, function() {
+                    return toArray(WILTON_hex_decode(hex)).join(",");
+                }, function() {
+                    return jsHexDecode(hex).join(",");
+                }),
+                compare("base64Encode", 2000, function() {
+                    return WILTON_base64_encode(buf);
+                }, function() {
+                    return jsBase64Encode(bytes);
+                }),
+                compare("base64Decode", 2000, function() {
+                    return toArray(WILTON_base64_decode(b64)).join(",");
+                }, function() {
+                    return jsBase64Decode(b64).join(",");
+                }),
+                compare("crc32", 2000, function() {
+                    return WILTON_crc32(buf);
+                }, function() {
+                    return jsCrc32(bytes);
+                }),
+                compare("fnv1a32", 2000, function() {
+                    return WILTON_fnv1a32(buf);
+                }, function() {
+                    return jsFnv1a32(bytes);
+                })
+            ];
+            print(JSON.stringify(results, null, 4));
+        }
+    };
+});
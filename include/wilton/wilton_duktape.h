@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   wilton_duktape.h
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#ifndef WILTON_DUKTAPE_H
+#define WILTON_DUKTAPE_H
+
+#include "wilton/wilton.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Types of values passed between JS code and native functions
+ */
+enum wilton_DuktapeType {
+    WILTON_DUKTAPE_TYPE_UNDEFINED = 0,
+    WILTON_DUKTAPE_TYPE_NULL = 1,
+    WILTON_DUKTAPE_TYPE_BOOLEAN = 2,
+    WILTON_DUKTAPE_TYPE_NUMBER = 3,
+    WILTON_DUKTAPE_TYPE_STRING = 4,
+    WILTON_DUKTAPE_TYPE_BUFFER = 5,
+    WILTON_DUKTAPE_TYPE_JSON = 6
+};
+
+/**
+ * Value passed between JS code and native functions, "number" field is used
+ * for booleans and numbers, "data" and "data_len" - for strings, buffers
+ * and JSON (JS objects and arrays are passed to native functions as JSON strings)
+ */
+typedef struct wilton_DuktapeValue {
+    int type;
+    double number;
+    const char* data;
+    int data_len;
+} wilton_DuktapeValue;
+
+/**
+ * Registers named output sink, JS code can write data chunks to it
+ * using "WILTON_stream_write(sinkName, chunk)" function, chunks are passed
+ * to the specified callback as soon as they are written.
+ * 
+ * Callback is called on the thread that runs JS code, it may block to
+ * apply backpressure to the writer. Callback must return "nullptr"
+ * on success or an error message allocated with "wilton_alloc".
+ * 
+ * Sink must be unregistered by the caller after the callback script,
+ * that uses it, is completed.
+ * 
+ * @param sink_name unique sink name
+ * @param sink_name_len sink name length
+ * @param sink_ctx opaque context passed to callback
+ * @param write_cb write callback
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_register_sink(
+        const char* sink_name,
+        int sink_name_len,
+        void* sink_ctx,
+        char* (*write_cb)(
+                void* sink_ctx,
+                const char* data,
+                int data_len));
+
+/**
+ * Unregisters named output sink
+ * 
+ * @param sink_name sink name
+ * @param sink_name_len sink name length
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_unregister_sink(
+        const char* sink_name,
+        int sink_name_len);
+
+/**
+ * Registers named input source, JS code can read data chunks from it
+ * on demand using "WILTON_stream_read(sourceName, maxLength)" function.
+ * Large payloads can be passed to callback scripts this way without
+ * copying them into JS heap upfront.
+ * 
+ * Callback is called on the thread that runs JS code, it must write
+ * the number of bytes read into "read_out" (zero on end of data) and
+ * return "nullptr" on success or an error message allocated with "wilton_alloc".
+ * 
+ * Source must be unregistered by the caller after the callback script,
+ * that uses it, is completed.
+ * 
+ * @param source_name unique source name
+ * @param source_name_len source name length
+ * @param source_ctx opaque context passed to callback
+ * @param read_cb read callback
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_register_source(
+        const char* source_name,
+        int source_name_len,
+        void* source_ctx,
+        char* (*read_cb)(
+                void* source_ctx,
+                char* buffer,
+                int buffer_len,
+                int* read_out));
+
+/**
+ * Registers named input source backed by the specified memory,
+ * memory is not copied and must stay valid until the source is unregistered
+ * 
+ * @param source_name unique source name
+ * @param source_name_len source name length
+ * @param data source data
+ * @param data_len source data length
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_register_memory_source(
+        const char* source_name,
+        int source_name_len,
+        const char* data,
+        int data_len);
+
+/**
+ * Unregisters named input source
+ * 
+ * @param source_name source name
+ * @param source_name_len source name length
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_unregister_source(
+        const char* source_name,
+        int source_name_len);
+
+/**
+ * Registers native function, that is bound directly to the global object
+ * (or to the namespace object for dotted names like "myhelpers.crc32")
+ * in all existing and all subsequently created engines. Arguments are taken
+ * directly from Duktape value stack without JSON serialization.
+ * 
+ * Argument values are only valid during the callback call. Callback must
+ * set the result type (it is "undefined" by default), string, buffer and
+ * JSON results data must be allocated with "wilton_alloc" and is freed
+ * by the engine. Callback must return "nullptr" on success or an error
+ * message allocated with "wilton_alloc", that is thrown to JS code.
+ * 
+ * Engines bind newly registered functions before running the next
+ * callback script.
+ * 
+ * @param fun_name function name, may include namespace
+ * @param fun_name_len function name length
+ * @param fun_ctx opaque context passed to callback
+ * @param fun_cb function callback
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_register_function(
+        const char* fun_name,
+        int fun_name_len,
+        void* fun_ctx,
+        char* (*fun_cb)(
+                void* fun_ctx,
+                const wilton_DuktapeValue* args,
+                int args_count,
+                wilton_DuktapeValue* result_out));
+
+/**
+ * Prepares module function for direct invocation with "wilton_duktape_invoke_handler".
+ * Each engine resolves the function with "require" once, on its first
+ * invocation, and keeps it in the heap stash, so subsequent invocations
+ * pass only the arguments. Same handle is returned for the same function.
+ * 
+ * @param module_name module name
+ * @param module_name_len module name length
+ * @param func_name function name
+ * @param func_name_len function name length
+ * @param handle_out prepared handler handle
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_prepare_handler(
+        const char* module_name,
+        int module_name_len,
+        const char* func_name,
+        int func_name_len,
+        int* handle_out);
+
+/**
+ * Invokes prepared handler in the engine of the current thread, the same
+ * way as "runscript_duktape" call does. Arguments are passed as JSON array,
+ * or as CBOR array with self-describe tag prefix, in this case result
+ * is returned as CBOR too.
+ * 
+ * Result must be freed by the caller with "wilton_free", it is
+ * set to "nullptr" for null and undefined results.
+ * 
+ * @param handle prepared handler handle
+ * @param args arguments array
+ * @param args_len arguments array length
+ * @param result_out result
+ * @param result_len_out result length
+ * @return error message or "nullptr" on success
+ */
+char* wilton_duktape_invoke_handler(
+        int handle,
+        const char* args,
+        int args_len,
+        char** result_out,
+        int* result_len_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WILTON_DUKTAPE_H */
+
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_allocator.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 3:50 PM
+ */
+
+#include "duktape_allocator.hpp"
+
+#include <cstdlib>
+
+#include "duktape_platform.hpp"
+
+namespace wilton {
+namespace duktape {
+
+// blocks are obtained from the owner thread's malloc arena, so with
+// the thread pinned they are first touched on the thread's NUMA node
+
+void* duktape_alloc(void* udata, duk_size_t size) {
+    auto counters = static_cast<duktape_heap_counters*> (udata);
+    void* res = std::malloc(size);
+    auto block_size = static_cast<int64_t> (allocated_block_size(res));
+    counters->allocated_bytes.fetch_add(static_cast<uint64_t> (block_size), std::memory_order_relaxed);
+    counters->live_bytes.fetch_add(block_size, std::memory_order_relaxed);
+    return res;
+}
+
+void* duktape_realloc(void* udata, void* ptr, duk_size_t size) {
+    auto counters = static_cast<duktape_heap_counters*> (udata);
+    auto old_size = static_cast<int64_t> (allocated_block_size(ptr));
+    void* res = std::realloc(ptr, size);
+    if (nullptr == res && 0 != size) {
+        // old block is left intact
+        return nullptr;
+    }
+    auto new_size = static_cast<int64_t> (allocated_block_size(res));
+    if (new_size > old_size) {
+        counters->allocated_bytes.fetch_add(static_cast<uint64_t> (new_size - old_size), std::memory_order_relaxed);
+    }
+    counters->live_bytes.fetch_add(new_size - old_size, std::memory_order_relaxed);
+    return res;
+}
+
+void duktape_free(void* udata, void* ptr) {
+    auto counters = static_cast<duktape_heap_counters*> (udata);
+    auto block_size = static_cast<int64_t> (allocated_block_size(ptr));
+    counters->live_bytes.fetch_sub(block_size, std::memory_order_relaxed);
+    std::free(ptr);
+}
+
+} // namespace
+}
+
+int wilton_duktape_exec_timeout_check(void* udata) {
+    auto counters = static_cast<const wilton::duktape::duktape_heap_counters*> (udata);
+    if (nullptr == counters || nullptr == counters->abort_requested) {
+        return 0;
+    }
+    // flag is kept until the next call, so pure JS loops cannot catch the error and continue
+    return counters->abort_requested->load(std::memory_order_relaxed) ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_allocator.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 3:50 PM
+ */
+
+#ifndef WILTON_DUKTAPE_ALLOCATOR_HPP
+#define WILTON_DUKTAPE_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "duktape.h"
+
+// "udata" must point to "duktape_heap_counters"
+#include "duktape_exec_timeout_check.h"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Per-heap allocation counters, updated by the heap owner thread
+ * and may be read from other threads
+ */
+class duktape_heap_counters {
+public:
+    // monotonic, only grows
+    std::atomic<uint64_t> allocated_bytes;
+    std::atomic<int64_t> live_bytes;
+    // set by the engine to its watchdog abort flag, checked by the
+    // bytecode executor in the performance build
+    const std::atomic<bool>* abort_requested = nullptr;
+
+    duktape_heap_counters() {
+        allocated_bytes.store(0, std::memory_order_relaxed);
+        live_bytes.store(0, std::memory_order_relaxed);
+    }
+
+    duktape_heap_counters(const duktape_heap_counters&) = delete;
+
+    duktape_heap_counters& operator=(const duktape_heap_counters&) = delete;
+};
+
+// allocation functions for "duk_create_heap", "udata" must point to "duktape_heap_counters"
+
+void* duktape_alloc(void* udata, duk_size_t size);
+
+void* duktape_realloc(void* udata, void* ptr, duk_size_t size);
+
+void duktape_free(void* udata, void* ptr);
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_ALLOCATOR_HPP */
+
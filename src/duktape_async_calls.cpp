@@ -0,0 +1,199 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_async_calls.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:40 PM
+ */
+
+#include "duktape_async_calls.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/wiltoncall.h"
+
+#include "duktape_tracer.hpp"
+#include "duktape_worker_pool.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+class async_call {
+public:
+    const void* const owner;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool complete = false;
+    bool failed = false;
+    duktape_async_result result;
+    std::string error;
+
+    async_call(const void* owner_engine) :
+    owner(owner_engine) { }
+
+    void run(const std::string& name, const std::string& input) {
+        auto res = duktape_async_result();
+        auto err = std::string();
+        try {
+            res = perform_wiltoncall(name, input);
+        } catch (const std::exception& e) {
+            err = e.what();
+        }
+        std::lock_guard<std::mutex> guard{mutex};
+        if (err.empty()) {
+            result = std::move(res);
+        } else {
+            failed = true;
+            error = std::move(err);
+        }
+        complete = true;
+        cv.notify_all();
+    }
+};
+
+} // namespace
+
+duktape_async_result perform_wiltoncall(const std::string& name, const std::string& input) {
+    char* out = nullptr;
+    int out_len = 0;
+    duktape_trace_span span("native", name.c_str(), name.length(), input.length());
+    auto err = wiltoncall(name.c_str(), static_cast<int> (name.length()),
+            input.c_str(), static_cast<int> (input.length()),
+            std::addressof(out), std::addressof(out_len));
+    if (nullptr != err) {
+        auto msg = TRACEMSG(err + "\n'wiltoncall' error for name: [" + name + "]");
+        wilton_free(err);
+        throw support::exception(msg);
+    }
+    span.set_output_len(static_cast<size_t> (out_len));
+    auto res = duktape_async_result();
+    if (nullptr != out) {
+        res.has_data = true;
+        res.data = std::string(out, static_cast<size_t> (out_len));
+        wilton_free(out);
+    }
+    return res;
+}
+
+class duktape_async_calls::impl : public sl::pimpl::object::impl {
+    std::atomic<uint64_t> last_handle;
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<async_call>> calls;
+
+public:
+    impl() :
+    last_handle(0) { }
+
+    uint64_t start(duktape_async_calls&, const void* owner, std::string name, std::string input) {
+        if (name.empty()) throw support::exception(TRACEMSG(
+                "Invalid empty call name specified"));
+        auto handle = last_handle.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto call = std::make_shared<async_call>(owner);
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            calls.insert(std::make_pair(handle, call));
+        }
+        auto pool = shared_worker_pool();
+        if (pool->is_worker_thread()) {
+            // completes before the handle is returned, wait does not block
+            call->run(name, input);
+            return handle;
+        }
+        auto name_ptr = std::make_shared<std::string>(std::move(name));
+        auto input_ptr = std::make_shared<std::string>(std::move(input));
+        try {
+            pool->submit([call, name_ptr, input_ptr] {
+                call->run(*name_ptr, *input_ptr);
+            });
+        } catch (...) {
+            std::lock_guard<std::mutex> guard{mutex};
+            calls.erase(handle);
+            throw;
+        }
+        return handle;
+    }
+
+    bool wait(duktape_async_calls&, const void* owner, uint64_t handle, int64_t timeout_millis,
+            duktape_async_result& result_out) {
+        auto call = find_call(owner, handle);
+        {
+            std::unique_lock<std::mutex> guard{call->mutex};
+            auto pred = [&call] {
+                return call->complete;
+            };
+            if (timeout_millis < 0) {
+                call->cv.wait(guard, pred);
+            } else if (!call->cv.wait_for(guard, std::chrono::milliseconds(timeout_millis), pred)) {
+                return false;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            calls.erase(handle);
+        }
+        // call is complete, no more writers
+        if (call->failed) {
+            throw support::exception(call->error);
+        }
+        result_out = std::move(call->result);
+        return true;
+    }
+
+    void discard(duktape_async_calls&, const void* owner) {
+        std::lock_guard<std::mutex> guard{mutex};
+        for (auto it = calls.begin(); it != calls.end();) {
+            if (owner == it->second->owner) {
+                // running calls hold their own reference
+                it = calls.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<async_call> find_call(const void* owner, uint64_t handle) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = calls.find(handle);
+        if (calls.end() == it || owner != it->second->owner) throw support::exception(TRACEMSG(
+                "Async call not found, handle: [" + sl::support::to_string(handle) + "]"));
+        return it->second;
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_async_calls, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_async_calls, uint64_t, start, (const void*)(std::string)(std::string), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_async_calls, bool, wait, (const void*)(uint64_t)(int64_t)(duktape_async_result&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_async_calls, void, discard, (const void*), (), support::exception)
+
+std::shared_ptr<duktape_async_calls> shared_async_calls() {
+    static auto calls = std::make_shared<duktape_async_calls>();
+    return calls;
+}
+
+} // namespace
+}
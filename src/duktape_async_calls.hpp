@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_async_calls.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_ASYNC_CALLS_HPP
+#define WILTON_DUKTAPE_ASYNC_CALLS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Result of the completed asynchronous wiltoncall
+ */
+class duktape_async_result {
+public:
+    bool has_data = false;
+    std::string data;
+};
+
+/**
+ * Performs a wiltoncall on the current thread
+ *
+ * @param name call name
+ * @param input call input
+ * @return call result
+ */
+duktape_async_result perform_wiltoncall(const std::string& name, const std::string& input);
+
+/**
+ * Wiltoncalls performed on the worker pool, so the engine can
+ * run JS code while slow native calls are in progress
+ */
+class duktape_async_calls : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_async_calls)
+
+    duktape_async_calls();
+
+    /**
+     * Calls started from the worker pool threads are performed inline,
+     * as waiting for a pool task from the pool thread can deadlock
+     *
+     * @param owner engine that started the call
+     * @return call handle
+     */
+    uint64_t start(const void* owner, std::string name, std::string input);
+
+    /**
+     * Call is released once its result is returned, call error
+     * is thrown as an exception, calls started by other engines
+     * are reported as not found
+     *
+     * @param owner engine that waits for the call
+     * @param timeout_millis negative value to wait without timeout
+     * @return false on timeout
+     */
+    bool wait(const void* owner, uint64_t handle, int64_t timeout_millis, duktape_async_result& result_out);
+
+    /**
+     * Releases calls, that were started but not waited for
+     *
+     * @param owner engine that started the calls
+     */
+    void discard(const void* owner);
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_async_calls> shared_async_calls();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_ASYNC_CALLS_HPP */
+
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   duktape_callback_info.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:30 PM
+ */
+
+#include "duktape_callback_info.hpp"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "staticlib/support.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "duktape_cbor.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+// calls by the threads they are running on
+std::mutex current_mutex;
+std::unordered_map<std::thread::id, const duktape_callback_info*> current_infos;
+
+// reads top-level fields of JSON object, other values are
+// skipped without allocations and are not validated
+class json_header_reader {
+    sl::io::span<const char> data;
+    size_t pos = 0;
+
+public:
+    explicit json_header_reader(sl::io::span<const char> data) :
+    data(data) { }
+
+    size_t offset() const {
+        return pos;
+    }
+
+    char peek() {
+        skip_whitespace();
+        if (pos >= data.size()) throw support::exception(TRACEMSG(
+                "JSON read error, unexpected end of input"));
+        return data.data()[pos];
+    }
+
+    void expect(char ch) {
+        if (ch != peek()) throw support::exception(TRACEMSG(
+                "JSON read error, unexpected character, position: [" + sl::support::to_string(pos) + "]"));
+        pos += 1;
+    }
+
+    bool consume(char ch) {
+        if (ch != peek()) {
+            return false;
+        }
+        pos += 1;
+        return true;
+    }
+
+    // null output skips the string
+    void read_string(std::string* out) {
+        expect('"');
+        for (;;) {
+            auto ch = next();
+            if ('"' == ch) {
+                return;
+            }
+            if ('\\' != ch) {
+                if (nullptr != out) {
+                    out->push_back(ch);
+                }
+                continue;
+            }
+            auto esc = next();
+            if ('u' == esc) {
+                auto cp = read_code_point();
+                if (nullptr != out) {
+                    append_utf8(*out, cp);
+                }
+                continue;
+            }
+            if (nullptr != out) {
+                out->push_back(unescape(esc));
+            }
+        }
+    }
+
+    // strings only, other values are skipped
+    void read_string_field(std::string& out) {
+        if ('"' == peek()) {
+            read_string(std::addressof(out));
+        } else {
+            skip_value();
+        }
+    }
+
+    // non-negative integers only, other values are skipped
+    uint64_t read_uint_field() {
+        peek();
+        auto start = pos;
+        uint64_t res = 0;
+        while (pos < data.size() && data.data()[pos] >= '0' && data.data()[pos] <= '9') {
+            auto digit = static_cast<uint64_t> (data.data()[pos] - '0');
+            res = res <= (UINT64_MAX - digit) / 10 ? res * 10 + digit : UINT64_MAX;
+            pos += 1;
+        }
+        if (start == pos || !at_value_end()) {
+            pos = start;
+            skip_value();
+            return 0;
+        }
+        return res;
+    }
+
+    void skip_value() {
+        auto ch = peek();
+        if ('"' == ch) {
+            read_string(nullptr);
+            return;
+        }
+        if ('{' == ch || '[' == ch) {
+            size_t depth = 0;
+            for (;;) {
+                auto cur = peek();
+                // strings may contain brackets
+                if ('"' == cur) {
+                    read_string(nullptr);
+                    continue;
+                }
+                pos += 1;
+                if ('{' == cur || '[' == cur) {
+                    depth += 1;
+                } else if ('}' == cur || ']' == cur) {
+                    depth -= 1;
+                    if (0 == depth) {
+                        return;
+                    }
+                }
+            }
+        }
+        // numbers and literals
+        auto start = pos;
+        while (!at_value_end()) {
+            pos += 1;
+        }
+        if (start == pos) throw support::exception(TRACEMSG(
+                "JSON read error, value expected, position: [" + sl::support::to_string(pos) + "]"));
+    }
+
+private:
+    void skip_whitespace() {
+        while (pos < data.size()) {
+            auto ch = data.data()[pos];
+            if (' ' != ch && '\t' != ch && '\r' != ch && '\n' != ch) {
+                break;
+            }
+            pos += 1;
+        }
+    }
+
+    bool at_value_end() {
+        if (pos >= data.size()) {
+            return true;
+        }
+        auto ch = data.data()[pos];
+        return ',' == ch || '}' == ch || ']' == ch || ' ' == ch || '\t' == ch || '\r' == ch || '\n' == ch;
+    }
+
+    char next() {
+        if (pos >= data.size()) throw support::exception(TRACEMSG(
+                "JSON read error, unterminated string"));
+        auto res = data.data()[pos];
+        pos += 1;
+        return res;
+    }
+
+    uint32_t read_hex4() {
+        uint32_t res = 0;
+        for (int i = 0; i < 4; i++) {
+            auto ch = next();
+            res <<= 4;
+            if (ch >= '0' && ch <= '9') {
+                res |= static_cast<uint32_t> (ch - '0');
+            } else if (ch >= 'a' && ch <= 'f') {
+                res |= static_cast<uint32_t> (ch - 'a' + 10);
+            } else if (ch >= 'A' && ch <= 'F') {
+                res |= static_cast<uint32_t> (ch - 'A' + 10);
+            } else throw support::exception(TRACEMSG(
+                    "JSON read error, invalid unicode escape, position: [" + sl::support::to_string(pos) + "]"));
+        }
+        return res;
+    }
+
+    uint32_t read_code_point() {
+        auto cp = read_hex4();
+        // surrogate pair
+        if (cp >= 0xd800 && cp < 0xdc00 && pos + 1 < data.size() &&
+                '\\' == data.data()[pos] && 'u' == data.data()[pos + 1]) {
+            pos += 2;
+            auto low = read_hex4();
+            if (low >= 0xdc00 && low < 0xe000) {
+                return 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+            }
+            // unpaired, low part is kept as is
+            return low;
+        }
+        return cp;
+    }
+
+    static char unescape(char esc) {
+        switch (esc) {
+        case 'b': return '\b';
+        case 'f': return '\f';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 't': return '\t';
+        default: return esc;
+        }
+    }
+
+    static void append_utf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char> (cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char> (0xc0 | (cp >> 6)));
+            out.push_back(static_cast<char> (0x80 | (cp & 0x3f)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char> (0xe0 | (cp >> 12)));
+            out.push_back(static_cast<char> (0x80 | ((cp >> 6) & 0x3f)));
+            out.push_back(static_cast<char> (0x80 | (cp & 0x3f)));
+        } else {
+            out.push_back(static_cast<char> (0xf0 | (cp >> 18)));
+            out.push_back(static_cast<char> (0x80 | ((cp >> 12) & 0x3f)));
+            out.push_back(static_cast<char> (0x80 | ((cp >> 6) & 0x3f)));
+            out.push_back(static_cast<char> (0x80 | (cp & 0x3f)));
+        }
+    }
+};
+
+void json_read_callback_info(sl::io::span<const char> data, duktape_callback_info& info) {
+    auto rd = json_header_reader(data);
+    rd.expect('{');
+    if (rd.consume('}')) {
+        return;
+    }
+    for (;;) {
+        auto key = std::string();
+        rd.read_string(std::addressof(key));
+        rd.expect(':');
+        if ("module" == key) {
+            rd.read_string_field(info.module);
+        } else if ("func" == key) {
+            rd.read_string_field(info.func);
+        } else if ("priority" == key) {
+            rd.read_string_field(info.priority);
+        } else if ("deadline" == key) {
+            info.deadline = rd.read_uint_field();
+        } else if ("args" == key) {
+            rd.peek();
+            auto start = rd.offset();
+            rd.skip_value();
+            info.args = sl::io::span<const char>(data.data() + start, rd.offset() - start);
+        } else {
+            rd.skip_value();
+        }
+        if (!rd.consume(',')) {
+            rd.expect('}');
+            return;
+        }
+    }
+}
+
+} // namespace
+
+duktape_callback_info read_callback_info(sl::io::span<const char> callback_script) {
+    auto res = duktape_callback_info();
+    if (is_cbor_payload(callback_script)) {
+        res.cbor = true;
+        res.valid = cbor_read_callback_info(callback_script, res);
+        return res;
+    }
+    try {
+        json_read_callback_info(callback_script, res);
+        res.valid = true;
+    } catch (const std::exception&) {
+        // invalid input is reported by the engine
+        res = duktape_callback_info();
+    }
+    return res;
+}
+
+duktape_callback_info_scope::duktape_callback_info_scope(const duktape_callback_info* info) :
+previous(nullptr),
+active(nullptr != info) {
+    if (!active) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard{current_mutex};
+    auto& en = current_infos[std::this_thread::get_id()];
+    previous = en;
+    en = info;
+}
+
+duktape_callback_info_scope::~duktape_callback_info_scope() STATICLIB_NOEXCEPT {
+    if (!active) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard{current_mutex};
+    auto it = current_infos.find(std::this_thread::get_id());
+    if (current_infos.end() == it) {
+        return;
+    }
+    if (nullptr != previous) {
+        it->second = previous;
+    } else {
+        current_infos.erase(it);
+    }
+}
+
+const duktape_callback_info* current_callback_info() {
+    std::lock_guard<std::mutex> guard{current_mutex};
+    auto it = current_infos.find(std::this_thread::get_id());
+    return current_infos.end() != it ? it->second : nullptr;
+}
+
+} // namespace
+}
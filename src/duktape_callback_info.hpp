@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   duktape_callback_info.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:30 PM
+ */
+
+#ifndef WILTON_DUKTAPE_CALLBACK_INFO_HPP
+#define WILTON_DUKTAPE_CALLBACK_INFO_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Routing fields of a callback script, read once per runscript_duktape
+ * call and shared by memoizer, scheduler and cost attribution,
+ * "args" are not parsed
+ */
+class duktape_callback_info {
+public:
+    // false when payload cannot be parsed, such input is reported by the engine
+    bool valid = false;
+    bool cbor = false;
+    std::string module;
+    std::string func;
+    std::string priority;
+    // epoch millis, zero when not specified
+    uint64_t deadline = 0;
+    // raw JSON text or CBOR item bytes pointing into the payload,
+    // empty if not specified
+    sl::io::span<const char> args;
+
+    duktape_callback_info() :
+    args(nullptr, 0) { }
+};
+
+/**
+ * Reads "module", "func", "priority", "deadline" and "args" fields
+ * from JSON or CBOR callback script, values of other fields and "args"
+ * are skipped without parsing, does not throw
+ *
+ * @param callback_script callback script payload
+ * @return callback info, not valid if payload cannot be parsed
+ */
+duktape_callback_info read_callback_info(sl::io::span<const char> callback_script);
+
+/**
+ * Makes callback info available to the engine, that runs the call on
+ * the current thread, previous entry is restored on destruction
+ * so nested calls are supported
+ */
+class duktape_callback_info_scope {
+    const duktape_callback_info* previous;
+    bool active;
+
+public:
+    /**
+     * @param info callback info, null pointer makes the scope a no-op
+     */
+    explicit duktape_callback_info_scope(const duktape_callback_info* info);
+
+    duktape_callback_info_scope(const duktape_callback_info_scope&) = delete;
+
+    duktape_callback_info_scope& operator=(const duktape_callback_info_scope&) = delete;
+
+    ~duktape_callback_info_scope() STATICLIB_NOEXCEPT;
+};
+
+/**
+ * @return info of the call running on the current thread, null if not set
+ */
+const duktape_callback_info* current_callback_info();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_CALLBACK_INFO_HPP */
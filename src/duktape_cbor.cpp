@@ -0,0 +1,650 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/* 
+ * File:   duktape_cbor.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 9:30 PM
+ */
+
+#include "duktape_cbor.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "staticlib/support.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "duktape_primitives.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const char* self_describe_prefix = "\xd9\xd9\xf7";
+const size_t self_describe_prefix_len = 3;
+const size_t max_depth = 256;
+// integers above 2^53 cannot be represented exactly in JS numbers
+const double max_safe_integer = 9007199254740991.0;
+
+const uint8_t major_unsigned = 0;
+const uint8_t major_negative = 1;
+const uint8_t major_bytes = 2;
+const uint8_t major_text = 3;
+const uint8_t major_array = 4;
+const uint8_t major_map = 5;
+const uint8_t major_tag = 6;
+const uint8_t major_simple = 7;
+
+const uint8_t info_indefinite = 31;
+const uint8_t simple_false = 20;
+const uint8_t simple_true = 21;
+const uint8_t simple_null = 22;
+const uint8_t simple_undefined = 23;
+const uint8_t simple_half = 25;
+const uint8_t simple_float = 26;
+const uint8_t simple_double = 27;
+const unsigned char break_byte = 0xff;
+
+// encoder
+
+void write_be(std::string& out, uint64_t value, size_t bytes_count) {
+    for (size_t i = bytes_count; i > 0; i--) {
+        out.push_back(static_cast<char> ((value >> ((i - 1) * 8)) & 0xff));
+    }
+}
+
+void write_head(std::string& out, uint8_t major, uint64_t value) {
+    auto mt = static_cast<uint8_t> (major << 5);
+    if (value < 24) {
+        out.push_back(static_cast<char> (mt | value));
+    } else if (value <= 0xff) {
+        out.push_back(static_cast<char> (mt | 24));
+        write_be(out, value, 1);
+    } else if (value <= 0xffff) {
+        out.push_back(static_cast<char> (mt | 25));
+        write_be(out, value, 2);
+    } else if (value <= 0xffffffff) {
+        out.push_back(static_cast<char> (mt | 26));
+        write_be(out, value, 4);
+    } else {
+        out.push_back(static_cast<char> (mt | 27));
+        write_be(out, value, 8);
+    }
+}
+
+void write_simple(std::string& out, uint8_t simple) {
+    out.push_back(static_cast<char> ((major_simple << 5) | simple));
+}
+
+void write_number(std::string& out, double num) {
+    if (num != num) {
+        // canonical half-precision NaN
+        write_simple(out, simple_half);
+        write_be(out, 0x7e00, 2);
+        return;
+    }
+    if (std::floor(num) == num && std::fabs(num) <= max_safe_integer && !(0 == num && std::signbit(num))) {
+        if (num >= 0) {
+            write_head(out, major_unsigned, static_cast<uint64_t> (num));
+        } else {
+            write_head(out, major_negative, static_cast<uint64_t> (-1 - num));
+        }
+        return;
+    }
+    auto fnum = static_cast<float> (num);
+    if (static_cast<double> (fnum) == num) {
+        uint32_t bits = 0;
+        std::memcpy(std::addressof(bits), std::addressof(fnum), sizeof(bits));
+        write_simple(out, simple_float);
+        write_be(out, bits, 4);
+    } else {
+        uint64_t bits = 0;
+        std::memcpy(std::addressof(bits), std::addressof(num), sizeof(bits));
+        write_simple(out, simple_double);
+        write_be(out, bits, 8);
+    }
+}
+
+void write_string(std::string& out, const char* str, size_t len) {
+    auto span = sl::io::span<const char>(str, len);
+    if (is_ascii(span)) {
+        write_head(out, major_text, len);
+        out.append(str, len);
+    } else {
+        auto utf8 = internal_to_utf8(span);
+        write_head(out, major_text, utf8.length());
+        out.append(utf8);
+    }
+}
+
+void encode_value(duk_context* ctx, duk_idx_t idx, std::string& out, size_t depth) {
+    if (depth > max_depth) throw support::exception(TRACEMSG(
+            "CBOR encode error, max nesting depth exceeded: [" + sl::support::to_string(max_depth) + "]"));
+    idx = duk_normalize_index(ctx, idx);
+    switch (duk_get_type(ctx, idx)) {
+    case DUK_TYPE_NULL:
+        write_simple(out, simple_null);
+        return;
+    case DUK_TYPE_BOOLEAN:
+        write_simple(out, duk_get_boolean(ctx, idx) ? simple_true : simple_false);
+        return;
+    case DUK_TYPE_NUMBER:
+        write_number(out, duk_get_number(ctx, idx));
+        return;
+    case DUK_TYPE_STRING: {
+        size_t len = 0;
+        const char* str = duk_get_lstring(ctx, idx, std::addressof(len));
+        write_string(out, str, len);
+        return;
+    }
+    case DUK_TYPE_BUFFER:
+    case DUK_TYPE_OBJECT:
+        break;
+    default:
+        // undefined, pointer, lightfunc
+        write_simple(out, simple_undefined);
+        return;
+    }
+    duk_size_t buf_len = 0;
+    void* buf = duk_get_buffer_data(ctx, idx, std::addressof(buf_len));
+    if (nullptr != buf || DUK_TYPE_BUFFER == duk_get_type(ctx, idx)) {
+        write_head(out, major_bytes, buf_len);
+        out.append(static_cast<const char*> (buf), buf_len);
+        return;
+    }
+    if (duk_is_function(ctx, idx)) {
+        write_simple(out, simple_undefined);
+        return;
+    }
+    duk_require_stack(ctx, 4);
+    if (duk_is_array(ctx, idx)) {
+        auto len = duk_get_length(ctx, idx);
+        write_head(out, major_array, len);
+        for (duk_size_t i = 0; i < len; i++) {
+            duk_get_prop_index(ctx, idx, static_cast<duk_uarridx_t> (i));
+            encode_value(ctx, -1, out, depth + 1);
+            duk_pop(ctx);
+        }
+        return;
+    }
+    // functions are skipped, same as in JSON
+    uint64_t count = 0;
+    duk_enum(ctx, idx, DUK_ENUM_OWN_PROPERTIES_ONLY);
+    while (duk_next(ctx, -1, 1)) {
+        if (!duk_is_function(ctx, -1)) {
+            count += 1;
+        }
+        duk_pop_2(ctx);
+    }
+    duk_pop(ctx);
+    write_head(out, major_map, count);
+    duk_enum(ctx, idx, DUK_ENUM_OWN_PROPERTIES_ONLY);
+    while (duk_next(ctx, -1, 1)) {
+        if (!duk_is_function(ctx, -1)) {
+            size_t len = 0;
+            const char* key = duk_get_lstring(ctx, -2, std::addressof(len));
+            write_string(out, key, len);
+            encode_value(ctx, -1, out, depth + 1);
+        }
+        duk_pop_2(ctx);
+    }
+    duk_pop(ctx);
+}
+
+// decoder
+
+class cbor_reader {
+    const unsigned char* data;
+    size_t len;
+    size_t pos = 0;
+
+public:
+    cbor_reader(sl::io::span<const char> span) :
+    data(reinterpret_cast<const unsigned char*> (span.data())),
+    len(span.size()) { }
+
+    size_t remaining() const {
+        return len - pos;
+    }
+
+    size_t position() const {
+        return pos;
+    }
+
+    void reset(size_t position) {
+        pos = position;
+    }
+
+    bool is_break() const {
+        return pos < len && break_byte == data[pos];
+    }
+
+    void skip_break() {
+        pos += 1;
+    }
+
+    uint8_t read_byte() {
+        ensure(1);
+        auto res = data[pos];
+        pos += 1;
+        return res;
+    }
+
+    uint64_t read_be(size_t bytes_count) {
+        ensure(bytes_count);
+        uint64_t res = 0;
+        for (size_t i = 0; i < bytes_count; i++) {
+            res = (res << 8) | data[pos + i];
+        }
+        pos += bytes_count;
+        return res;
+    }
+
+    const char* read_bytes(uint64_t count) {
+        if (count > remaining()) throw support::exception(TRACEMSG(
+                "CBOR decode error, invalid length: [" + sl::support::to_string(count) + "]," +
+                " bytes remaining: [" + sl::support::to_string(remaining()) + "]"));
+        auto res = reinterpret_cast<const char*> (data + pos);
+        pos += static_cast<size_t> (count);
+        return res;
+    }
+
+    // returns argument value, info is set to additional information bits
+    uint64_t read_head(uint8_t& major, uint8_t& info) {
+        auto ib = read_byte();
+        major = static_cast<uint8_t> (ib >> 5);
+        info = static_cast<uint8_t> (ib & 0x1f);
+        if (info < 24) {
+            return info;
+        }
+        switch (info) {
+        case 24: return read_be(1);
+        case 25: return read_be(2);
+        case 26: return read_be(4);
+        case 27: return read_be(8);
+        case info_indefinite: return 0;
+        default: throw support::exception(TRACEMSG(
+                "CBOR decode error, invalid additional information: [" + sl::support::to_string(info) + "]"));
+        }
+    }
+
+private:
+    void ensure(size_t count) {
+        if (count > remaining()) throw support::exception(TRACEMSG(
+                "CBOR decode error, unexpected end of data"));
+    }
+};
+
+double half_to_double(uint64_t half) {
+    auto exp = static_cast<int> ((half >> 10) & 0x1f);
+    auto mant = static_cast<double> (half & 0x3ff);
+    double res = 0;
+    if (0 == exp) {
+        res = std::ldexp(mant, -24);
+    } else if (31 == exp) {
+        res = 0 == mant ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    } else {
+        res = std::ldexp(mant + 1024, exp - 25);
+    }
+    return 0 != (half & 0x8000) ? -res : res;
+}
+
+void read_string_chunks(cbor_reader& rd, uint8_t major, uint8_t info, uint64_t value, std::string& out) {
+    if (info_indefinite != info) {
+        out.append(rd.read_bytes(value), static_cast<size_t> (value));
+        return;
+    }
+    while (!rd.is_break()) {
+        uint8_t chunk_major = 0;
+        uint8_t chunk_info = 0;
+        auto chunk_len = rd.read_head(chunk_major, chunk_info);
+        if (major != chunk_major || info_indefinite == chunk_info) throw support::exception(TRACEMSG(
+                "CBOR decode error, invalid string chunk, major type: [" + sl::support::to_string(chunk_major) + "]"));
+        out.append(rd.read_bytes(chunk_len), static_cast<size_t> (chunk_len));
+    }
+    rd.skip_break();
+}
+
+void push_bytes(duk_context* ctx, const char* data, size_t len) {
+    void* buf = duk_push_fixed_buffer(ctx, len);
+    if (len > 0) {
+        std::memcpy(buf, data, len);
+    }
+}
+
+void decode_value(duk_context* ctx, cbor_reader& rd, size_t depth) {
+    if (depth > max_depth) throw support::exception(TRACEMSG(
+            "CBOR decode error, max nesting depth exceeded: [" + sl::support::to_string(max_depth) + "]"));
+    uint8_t major = 0;
+    uint8_t info = 0;
+    auto value = rd.read_head(major, info);
+    duk_require_stack(ctx, 4);
+    switch (major) {
+    case major_unsigned:
+        duk_push_number(ctx, static_cast<duk_double_t> (value));
+        return;
+    case major_negative:
+        duk_push_number(ctx, -1 - static_cast<duk_double_t> (value));
+        return;
+    case major_bytes:
+    case major_text: {
+        if (info_indefinite != info) {
+            // definite strings are read in place without an intermediate buffer
+            // in the reader, the push copies them into the heap, non-ASCII
+            // text is converted to the internal encoding in a temporary string first
+            auto data = rd.read_bytes(value);
+            auto len = static_cast<size_t> (value);
+            if (major_bytes == major) {
+                push_bytes(ctx, data, len);
+            } else {
+                push_utf8_as_string(ctx, sl::io::span<const char>(data, len));
+            }
+            return;
+        }
+        auto str = std::string();
+        read_string_chunks(rd, major, info, value, str);
+        if (major_bytes == major) {
+            push_bytes(ctx, str.data(), str.length());
+        } else {
+            push_utf8_as_string(ctx, sl::io::span<const char>(str.data(), str.length()));
+        }
+        return;
+    }
+    case major_array: {
+        // every element takes at least one byte
+        if (info_indefinite != info && value > rd.remaining()) throw support::exception(TRACEMSG(
+                "CBOR decode error, invalid array length: [" + sl::support::to_string(value) + "]"));
+        duk_push_array(ctx);
+        duk_uarridx_t i = 0;
+        while (info_indefinite == info ? !rd.is_break() : i < value) {
+            decode_value(ctx, rd, depth + 1);
+            duk_put_prop_index(ctx, -2, i);
+            i += 1;
+        }
+        if (info_indefinite == info) {
+            rd.skip_break();
+        }
+        return;
+    }
+    case major_map: {
+        if (info_indefinite != info && value > rd.remaining() / 2) throw support::exception(TRACEMSG(
+                "CBOR decode error, invalid map length: [" + sl::support::to_string(value) + "]"));
+        duk_push_object(ctx);
+        uint64_t i = 0;
+        while (info_indefinite == info ? !rd.is_break() : i < value) {
+            // non-string keys are coerced to strings
+            decode_value(ctx, rd, depth + 1);
+            decode_value(ctx, rd, depth + 1);
+            duk_put_prop(ctx, -3);
+            i += 1;
+        }
+        if (info_indefinite == info) {
+            rd.skip_break();
+        }
+        return;
+    }
+    case major_tag:
+        // tagged item is decoded as is, including self-describe tag
+        decode_value(ctx, rd, depth + 1);
+        return;
+    default:
+        break;
+    }
+    switch (info) {
+    case simple_false:
+        duk_push_false(ctx);
+        return;
+    case simple_true:
+        duk_push_true(ctx);
+        return;
+    case simple_null:
+        duk_push_null(ctx);
+        return;
+    case simple_half:
+        duk_push_number(ctx, half_to_double(value));
+        return;
+    case simple_float: {
+        auto bits = static_cast<uint32_t> (value);
+        float fnum = 0;
+        std::memcpy(std::addressof(fnum), std::addressof(bits), sizeof(fnum));
+        duk_push_number(ctx, static_cast<duk_double_t> (fnum));
+        return;
+    }
+    case simple_double: {
+        double num = 0;
+        std::memcpy(std::addressof(num), std::addressof(value), sizeof(num));
+        duk_push_number(ctx, num);
+        return;
+    }
+    case info_indefinite:
+        throw support::exception(TRACEMSG("CBOR decode error, unexpected break"));
+    default:
+        // undefined and unassigned simple values
+        duk_push_undefined(ctx);
+    }
+}
+
+void skip_value(cbor_reader& rd, size_t depth) {
+    if (depth > max_depth) throw support::exception(TRACEMSG(
+            "CBOR decode error, max nesting depth exceeded: [" + sl::support::to_string(max_depth) + "]"));
+    uint8_t major = 0;
+    uint8_t info = 0;
+    auto value = rd.read_head(major, info);
+    switch (major) {
+    case major_bytes:
+    case major_text:
+        if (info_indefinite != info) {
+            rd.read_bytes(value);
+        } else {
+            auto str = std::string();
+            read_string_chunks(rd, major, info, value, str);
+        }
+        return;
+    case major_array:
+    case major_map: {
+        auto items = major_map == major ? 2 : 1;
+        uint64_t i = 0;
+        while (info_indefinite == info ? !rd.is_break() : i < value) {
+            for (int j = 0; j < items; j++) {
+                skip_value(rd, depth + 1);
+            }
+            i += 1;
+        }
+        if (info_indefinite == info) {
+            rd.skip_break();
+        }
+        return;
+    }
+    case major_tag:
+        skip_value(rd, depth + 1);
+        return;
+    case major_simple:
+        if (info_indefinite == info) throw support::exception(TRACEMSG(
+                "CBOR decode error, unexpected break"));
+        return;
+    default:
+        // integers are fully read with the head
+        return;
+    }
+}
+
+// text and integer values only, other types leave the output untouched
+void read_text_field(cbor_reader& rd, std::string& out) {
+    uint8_t major = 0;
+    uint8_t info = 0;
+    auto start = rd.position();
+    auto value = rd.read_head(major, info);
+    if (major_text == major) {
+        read_string_chunks(rd, major, info, value, out);
+    } else {
+        rd.reset(start);
+        skip_value(rd, 1);
+    }
+}
+
+void read_uint_field(cbor_reader& rd, uint64_t& out) {
+    uint8_t major = 0;
+    uint8_t info = 0;
+    auto start = rd.position();
+    auto value = rd.read_head(major, info);
+    if (major_unsigned == major) {
+        out = value;
+    } else if (major_simple == major && simple_double == info) {
+        double num = 0;
+        std::memcpy(std::addressof(num), std::addressof(value), sizeof(num));
+        if (num > 0 && num <= max_safe_integer) {
+            out = static_cast<uint64_t> (num);
+        }
+    } else {
+        rd.reset(start);
+        skip_value(rd, 1);
+    }
+}
+
+sl::io::span<const char> get_bytes(duk_context* ctx, duk_idx_t idx) {
+    duk_size_t len = 0;
+    void* data = duk_get_buffer_data(ctx, idx, std::addressof(len));
+    if (nullptr != data || DUK_TYPE_BUFFER == duk_get_type(ctx, idx)) {
+        return sl::io::span<const char>(static_cast<const char*> (data), len);
+    }
+    const char* str = duk_get_lstring(ctx, idx, std::addressof(len));
+    if (nullptr == str) {
+        throw support::exception(TRACEMSG("Invalid data specified, buffer or string expected"));
+    }
+    return sl::io::span<const char>(str, len);
+}
+
+// Errors are pushed as Duktape error objects, so no C++ objects
+// are in scope when they are thrown
+
+bool encode_arg(duk_context* ctx) {
+    try {
+        auto out = std::string();
+        cbor_encode(ctx, 0, out);
+        push_bytes(ctx, out.data(), out.length());
+        return true;
+    } catch (const std::exception& e) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s", e.what());
+        return false;
+    }
+}
+
+bool decode_arg(duk_context* ctx) {
+    try {
+        cbor_decode(ctx, get_bytes(ctx, 0));
+        return true;
+    } catch (const std::exception& e) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s", e.what());
+        return false;
+    }
+}
+
+// [value] -> [buffer]
+duk_ret_t cbor_encode_func(duk_context* ctx) {
+    if (!encode_arg(ctx)) {
+        duk_throw(ctx);
+    }
+    return 1;
+}
+
+// [buffer|string] -> [value]
+duk_ret_t cbor_decode_func(duk_context* ctx) {
+    if (!decode_arg(ctx)) {
+        duk_throw(ctx);
+    }
+    return 1;
+}
+
+} // namespace
+
+bool is_cbor_payload(sl::io::span<const char> data) {
+    return data.size() >= self_describe_prefix_len &&
+            0 == std::memcmp(data.data(), self_describe_prefix, self_describe_prefix_len);
+}
+
+void cbor_encode(duk_context* ctx, duk_idx_t idx, std::string& out) {
+    out.append(self_describe_prefix, self_describe_prefix_len);
+    encode_value(ctx, idx, out, 0);
+}
+
+void cbor_decode(duk_context* ctx, sl::io::span<const char> data) {
+    auto rd = cbor_reader(data);
+    decode_value(ctx, rd, 0);
+    if (rd.remaining() > 0) {
+        duk_pop(ctx);
+        throw support::exception(TRACEMSG(
+                "CBOR decode error, trailing data, bytes count: [" + sl::support::to_string(rd.remaining()) + "]"));
+    }
+}
+
+bool cbor_read_callback_info(sl::io::span<const char> data, duktape_callback_info& info) {
+    try {
+        auto rd = cbor_reader(data);
+        uint8_t major = 0;
+        uint8_t minfo = 0;
+        auto value = rd.read_head(major, minfo);
+        // self-describe tag
+        while (major_tag == major) {
+            value = rd.read_head(major, minfo);
+        }
+        if (major_map != major) {
+            return false;
+        }
+        uint64_t i = 0;
+        while (info_indefinite == minfo ? !rd.is_break() : i < value) {
+            auto key = std::string();
+            read_text_field(rd, key);
+            if ("module" == key) {
+                read_text_field(rd, info.module);
+            } else if ("func" == key) {
+                read_text_field(rd, info.func);
+            } else if ("priority" == key) {
+                read_text_field(rd, info.priority);
+            } else if ("deadline" == key) {
+                read_uint_field(rd, info.deadline);
+            } else if ("args" == key) {
+                auto start = rd.position();
+                skip_value(rd, 1);
+                info.args = sl::io::span<const char>(data.data() + start, rd.position() - start);
+            } else {
+                skip_value(rd, 1);
+            }
+            i += 1;
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void register_cbor_functions(duk_context* ctx) {
+    duk_push_global_object(ctx);
+    duk_push_c_function(ctx, cbor_encode_func, 1);
+    duk_put_prop_string(ctx, -2, "WILTON_cbor_encode");
+    duk_push_c_function(ctx, cbor_decode_func, 1);
+    duk_put_prop_string(ctx, -2, "WILTON_cbor_decode");
+    duk_pop(ctx);
+}
+
+} // namespace
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_cbor.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 9:30 PM
+ */
+
+#ifndef WILTON_DUKTAPE_CBOR_HPP
+#define WILTON_DUKTAPE_CBOR_HPP
+
+#include <string>
+
+#include "duktape.h"
+
+#include "staticlib/io.hpp"
+
+#include "duktape_callback_info.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Payloads, that start with CBOR self-describe tag (55799),
+ * are treated as CBOR instead of JSON
+ *
+ * @param data payload
+ * @return true if payload starts with self-describe tag
+ */
+bool is_cbor_payload(sl::io::span<const char> data);
+
+/**
+ * Encodes value with self-describe tag prefix, strings are written as
+ * UTF-8 text, buffers as byte strings, integral numbers as integers,
+ * functions and undefined as CBOR undefined, throws on too deep nesting
+ *
+ * @param ctx Duktape context
+ * @param idx value index
+ * @param out output string, bytes are appended
+ */
+void cbor_encode(duk_context* ctx, duk_idx_t idx, std::string& out);
+
+/**
+ * Decodes CBOR data and pushes resulting value, byte strings are pushed
+ * as buffers, tags are ignored, throws on malformed or trailing data
+ *
+ * @param ctx Duktape context
+ * @param data CBOR data
+ */
+void cbor_decode(duk_context* ctx, sl::io::span<const char> data);
+
+/**
+ * Reads callback script fields from a CBOR map without a Duktape context,
+ * "args" item is not decoded, its raw bytes are referenced instead
+ *
+ * @param data CBOR callback script
+ * @param info output info
+ * @return false if data is not a valid CBOR map
+ */
+bool cbor_read_callback_info(sl::io::span<const char> data, duktape_callback_info& info);
+
+/**
+ * Registers WILTON_cbor_encode and WILTON_cbor_decode into the global object
+ *
+ * @param ctx Duktape context
+ */
+void register_cbor_functions(duk_context* ctx);
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_CBOR_HPP */
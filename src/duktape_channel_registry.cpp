@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_channel_registry.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 1:40 PM
+ */
+
+#include "duktape_channel_registry.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+// bounded MPMC queue, blocking operations
+// need a waiting primitive, so mutex is used instead of lock-free ring
+class channel {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<duktape_channel_message> queue;
+    size_t capacity;
+    bool closed = false;
+
+public:
+    channel(uint32_t max_messages) :
+    capacity(max_messages) { }
+
+    bool send(duktape_channel_message& message, int64_t timeout_millis, const std::string& name) {
+        std::unique_lock<std::mutex> guard{mutex};
+        auto pred = [this] {
+            return closed || queue.size() < capacity;
+        };
+        if (!wait(not_full, guard, timeout_millis, pred)) {
+            return false;
+        }
+        if (closed) throw support::exception(TRACEMSG(
+                "Channel is closed, name: [" + name + "]"));
+        queue.emplace_back(std::move(message));
+        not_empty.notify_one();
+        return true;
+    }
+
+    duktape_channel_status receive(duktape_channel_message& message_out, int64_t timeout_millis) {
+        std::unique_lock<std::mutex> guard{mutex};
+        auto pred = [this] {
+            return closed || !queue.empty();
+        };
+        if (!wait(not_empty, guard, timeout_millis, pred)) {
+            return duktape_channel_status::timeout;
+        }
+        if (queue.empty()) {
+            return duktape_channel_status::closed;
+        }
+        message_out = std::move(queue.front());
+        queue.pop_front();
+        not_full.notify_one();
+        return duktape_channel_status::received;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> guard{mutex};
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    bool is_closed() {
+        std::lock_guard<std::mutex> guard{mutex};
+        return closed;
+    }
+
+private:
+    template<typename Predicate>
+    bool wait(std::condition_variable& cv, std::unique_lock<std::mutex>& guard,
+            int64_t timeout_millis, Predicate pred) {
+        if (timeout_millis < 0) {
+            cv.wait(guard, pred);
+            return true;
+        }
+        return cv.wait_for(guard, std::chrono::milliseconds(timeout_millis), pred);
+    }
+};
+
+} // namespace
+
+class duktape_channel_registry::impl : public sl::pimpl::object::impl {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<channel>> channels;
+
+public:
+    impl() { }
+
+    void create(duktape_channel_registry&, const std::string& name, uint32_t capacity) {
+        if (name.empty()) throw support::exception(TRACEMSG(
+                "Invalid empty channel name specified"));
+        if (0 == capacity) throw support::exception(TRACEMSG(
+                "Invalid zero capacity specified, channel: [" + name + "]"));
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = channels.insert(std::make_pair(name, std::make_shared<channel>(capacity)));
+        if (!res.second) {
+            // receivers of the closed channel still hold it
+            if (!res.first->second->is_closed()) throw support::exception(TRACEMSG(
+                    "Channel already exists, name: [" + name + "]"));
+            res.first->second = std::make_shared<channel>(capacity);
+        }
+    }
+
+    void close(duktape_channel_registry&, const std::string& name) {
+        auto ch = find_channel(name);
+        // wakes up waiting threads, queued messages are left to receivers
+        ch->close();
+    }
+
+    bool send(duktape_channel_registry&, const std::string& name, duktape_channel_message& message,
+            int64_t timeout_millis) {
+        auto ch = find_channel(name);
+        return ch->send(message, timeout_millis, name);
+    }
+
+    duktape_channel_status receive(duktape_channel_registry&, const std::string& name,
+            duktape_channel_message& message_out, int64_t timeout_millis) {
+        auto ch = find_channel(name);
+        auto status = ch->receive(message_out, timeout_millis);
+        if (duktape_channel_status::closed == status) {
+            std::lock_guard<std::mutex> guard{mutex};
+            auto it = channels.find(name);
+            // channel may be already replaced
+            if (channels.end() != it && ch == it->second) {
+                channels.erase(it);
+            }
+        }
+        return status;
+    }
+
+private:
+    std::shared_ptr<channel> find_channel(const std::string& name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = channels.find(name);
+        if (channels.end() == it) throw support::exception(TRACEMSG(
+                "Channel not found, name: [" + name + "]"));
+        return it->second;
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_channel_registry, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_channel_registry, void, create, (const std::string&)(uint32_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_channel_registry, void, close, (const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_channel_registry, bool, send, (const std::string&)(duktape_channel_message&)(int64_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_channel_registry, duktape_channel_status, receive, (const std::string&)(duktape_channel_message&)(int64_t), (), support::exception)
+
+std::shared_ptr<duktape_channel_registry> shared_channel_registry() {
+    static auto registry = std::make_shared<duktape_channel_registry>();
+    return registry;
+}
+
+} // namespace
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_channel_registry.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 1:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_CHANNEL_REGISTRY_HPP
+#define WILTON_DUKTAPE_CHANNEL_REGISTRY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Message passed between engines, data is moved
+ * through the channel without copying
+ */
+class duktape_channel_message {
+public:
+    std::string data;
+    bool binary = false;
+
+    duktape_channel_message() { }
+
+    duktape_channel_message(std::string&& message_data, bool message_binary) :
+    data(std::move(message_data)),
+    binary(message_binary) { }
+
+    duktape_channel_message(const duktape_channel_message&) = delete;
+
+    duktape_channel_message& operator=(const duktape_channel_message&) = delete;
+
+    duktape_channel_message(duktape_channel_message&& other) :
+    data(std::move(other.data)),
+    binary(other.binary) { }
+
+    duktape_channel_message& operator=(duktape_channel_message&& other) {
+        this->data = std::move(other.data);
+        this->binary = other.binary;
+        return *this;
+    }
+};
+
+/**
+ * Result of receiving from a channel
+ */
+enum class duktape_channel_status {
+    received,
+    timeout,
+    // channel was closed and all queued messages were received
+    closed
+};
+
+/**
+ * Closed channels are kept in registry until their queued
+ * messages are received, then they are removed
+ */
+class duktape_channel_registry : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_channel_registry)
+
+    duktape_channel_registry();
+
+    /**
+     * Channel, that is closed, but not yet drained, is replaced
+     */
+    void create(const std::string& name, uint32_t capacity);
+
+    /**
+     * Queued messages are still delivered to receivers, send
+     * to the closed channel fails
+     */
+    void close(const std::string& name);
+
+    /**
+     * Negative timeout means waiting indefinitely, zero - no waiting
+     *
+     * @return false on timeout
+     */
+    bool send(const std::string& name, duktape_channel_message& message, int64_t timeout_millis);
+
+    /**
+     * Negative timeout means waiting indefinitely, zero - no waiting,
+     * channel is removed from registry after "closed" is returned
+     *
+     * @return receive status
+     */
+    duktape_channel_status receive(const std::string& name, duktape_channel_message& message_out,
+            int64_t timeout_millis);
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_channel_registry> shared_channel_registry();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_CHANNEL_REGISTRY_HPP */
+
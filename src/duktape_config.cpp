@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_config.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 2:30 PM
+ */
+
+#include "duktape_config.hpp"
+
+#include <memory>
+
+#include "staticlib/support.hpp"
+
+#include "wilton/wiltoncall.h"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+sl::json::value load_wilton_config() {
+    char* config = nullptr;
+    int config_len = 0;
+
+    auto err_conf = wilton_config(std::addressof(config), std::addressof(config_len));
+    if (nullptr != err_conf) wilton::support::throw_wilton_error(err_conf, TRACEMSG(err_conf));
+    auto deferred = sl::support::defer([config] () STATICLIB_NOEXCEPT {
+        wilton_free(config);
+    }); // execute lambda on destruction
+
+    return sl::json::load({const_cast<const char*> (config), static_cast<size_t> (config_len)});
+}
+
+sl::json::value load_duktape_config() {
+    auto cf = load_wilton_config();
+    auto& section = cf["duktape"];
+    if (sl::json::type::object != section.json_type()) {
+        return sl::json::value(std::vector<sl::json::field>());
+    }
+    return section.clone();
+}
+
+} // namespace
+}
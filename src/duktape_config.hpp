@@ -0,0 +1,50 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_config.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 2:30 PM
+ */
+
+#ifndef WILTON_DUKTAPE_CONFIG_HPP
+#define WILTON_DUKTAPE_CONFIG_HPP
+
+#include "staticlib/json.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Loads wilton config
+ * 
+ * @return config JSON
+ */
+sl::json::value load_wilton_config();
+
+/**
+ * Loads engine-specific section ("duktape" object) of wilton config
+ * 
+ * @return engine config JSON, empty object if section is not specified
+ */
+sl::json::value load_duktape_config();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_CONFIG_HPP */
+
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_cost_tracker.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:00 PM
+ */
+
+#include "duktape_cost_tracker.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "duktape_config.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const uint32_t default_max_entries = 4096;
+const uint32_t default_top = 20;
+const char key_separator = '\x1f';
+
+class cost_entry {
+public:
+    std::string module;
+    std::string func;
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t cpu_micros = 0;
+    uint64_t wall_micros = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t native_micros = 0;
+    uint64_t native_calls = 0;
+
+    cost_entry(const std::string& entry_module, const std::string& entry_func) :
+    module(entry_module),
+    func(entry_func) { }
+
+    void add(const duktape_call_cost& cost) {
+        calls += 1;
+        if (cost.failed) {
+            failures += 1;
+        }
+        cpu_micros += cost.cpu_micros;
+        wall_micros += cost.wall_micros;
+        allocated_bytes += cost.allocated_bytes;
+        native_micros += cost.native_micros;
+        native_calls += cost.native_calls;
+    }
+
+    uint64_t sort_value(const std::string& sort_by) const {
+        if ("wall" == sort_by) return wall_micros;
+        if ("alloc" == sort_by) return allocated_bytes;
+        if ("native" == sort_by) return native_micros;
+        if ("calls" == sort_by) return calls;
+        return cpu_micros;
+    }
+
+    // CPU share is relative to all recorded calls
+    sl::json::value to_json(uint64_t total_cpu_micros) const {
+        return sl::json::value({
+            { "module", module },
+            { "func", func },
+            { "calls", static_cast<int64_t> (calls) },
+            { "failures", static_cast<int64_t> (failures) },
+            { "cpuMicros", static_cast<int64_t> (cpu_micros) },
+            { "wallMicros", static_cast<int64_t> (wall_micros) },
+            { "allocatedBytes", static_cast<int64_t> (allocated_bytes) },
+            { "nativeMicros", static_cast<int64_t> (native_micros) },
+            { "nativeCalls", static_cast<int64_t> (native_calls) },
+            { "avgCpuMicros", static_cast<int64_t> (calls > 0 ? cpu_micros / calls : 0) },
+            { "avgWallMicros", static_cast<int64_t> (calls > 0 ? wall_micros / calls : 0) },
+            { "avgAllocatedBytes", static_cast<int64_t> (calls > 0 ? allocated_bytes / calls : 0) },
+            { "cpuShare", total_cpu_micros > 0 ?
+                    static_cast<double> (cpu_micros) / static_cast<double> (total_cpu_micros) : 0.0 }
+        });
+    }
+};
+
+} // namespace
+
+class duktape_cost_tracker::impl : public sl::pimpl::object::impl {
+    bool enabled;
+    uint32_t max_entries;
+    std::mutex mutex;
+    std::unordered_map<std::string, cost_entry> entries;
+    cost_entry overflow;
+
+public:
+    impl(bool enabled, uint32_t max_entries) :
+    enabled(enabled),
+    max_entries(max_entries > 0 ? max_entries : default_max_entries),
+    overflow(std::string(), std::string()) { }
+
+    bool is_enabled(const duktape_cost_tracker&) const {
+        return enabled;
+    }
+
+    void record(duktape_cost_tracker&, const std::string& module, const std::string& func,
+            const duktape_call_cost& cost) {
+        if (!enabled) {
+            return;
+        }
+        auto key = module + key_separator + func;
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = entries.find(key);
+        if (entries.end() != it) {
+            it->second.add(cost);
+        } else if (entries.size() < max_entries) {
+            auto res = entries.insert(std::make_pair(std::move(key), cost_entry(module, func)));
+            res.first->second.add(cost);
+        } else {
+            overflow.add(cost);
+        }
+    }
+
+    sl::json::value top(duktape_cost_tracker&, const sl::json::value& options) {
+        if (!enabled) {
+            return sl::json::value({
+                { "enabled", false }
+            });
+        }
+        auto limit = options["top"].as_uint32(default_top);
+        auto& sort_by = options["sortBy"].as_string();
+        auto reset = options["reset"].as_bool(false);
+        auto list = std::vector<cost_entry>();
+        uint64_t total_cpu = 0;
+        uint64_t total_calls = 0;
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            list.reserve(entries.size() + 1);
+            for (auto& pa : entries) {
+                list.push_back(pa.second);
+            }
+            if (overflow.calls > 0) {
+                list.push_back(overflow);
+            }
+            if (reset) {
+                entries.clear();
+                overflow = cost_entry(std::string(), std::string());
+            }
+        }
+        for (auto& en : list) {
+            total_cpu += en.cpu_micros;
+            total_calls += en.calls;
+        }
+        std::sort(list.begin(), list.end(), [&sort_by](const cost_entry& a, const cost_entry& b) {
+            return a.sort_value(sort_by) > b.sort_value(sort_by);
+        });
+        auto arr = std::vector<sl::json::value>();
+        for (size_t i = 0; i < list.size() && i < limit; i++) {
+            arr.emplace_back(list[i].to_json(total_cpu));
+        }
+        return sl::json::value({
+            { "enabled", true },
+            { "functions", static_cast<int64_t> (list.size()) },
+            { "totalCalls", static_cast<int64_t> (total_calls) },
+            { "totalCpuMicros", static_cast<int64_t> (total_cpu) },
+            { "entries", std::move(arr) }
+        });
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_cost_tracker, (bool)(uint32_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_cost_tracker, bool, is_enabled, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_cost_tracker, void, record, (const std::string&)(const std::string&)(const duktape_call_cost&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_cost_tracker, sl::json::value, top, (const sl::json::value&), (), support::exception)
+
+std::shared_ptr<duktape_cost_tracker> shared_cost_tracker() {
+    static auto tracker = [] {
+        auto cf = load_duktape_config();
+        auto& cc = cf["costAttribution"];
+        return std::make_shared<duktape_cost_tracker>(cc["enabled"].as_bool(false),
+                cc["maxEntries"].as_uint32(default_max_entries));
+    } ();
+    return tracker;
+}
+
+} // namespace
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_cost_tracker.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:00 PM
+ */
+
+#ifndef WILTON_DUKTAPE_COST_TRACKER_HPP
+#define WILTON_DUKTAPE_COST_TRACKER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Time spent in native calls, accumulated by the engine thread
+ */
+class duktape_native_time {
+public:
+    uint64_t micros = 0;
+    uint64_t calls = 0;
+};
+
+/**
+ * Costs of a single callback script run
+ */
+class duktape_call_cost {
+public:
+    uint64_t cpu_micros = 0;
+    uint64_t wall_micros = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t native_micros = 0;
+    uint64_t native_calls = 0;
+    bool failed = false;
+};
+
+/**
+ * Aggregates callback script costs by module and function names
+ */
+class duktape_cost_tracker : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_cost_tracker)
+
+    /**
+     * Costs of functions, that do not fit into "max_entries",
+     * are aggregated under empty module name
+     *
+     * @param enabled whether costs are recorded
+     * @param max_entries max number of distinct functions
+     */
+    duktape_cost_tracker(bool enabled, uint32_t max_entries);
+
+    bool is_enabled() const;
+
+    void record(const std::string& module, const std::string& func, const duktape_call_cost& cost);
+
+    /**
+     * Options format: {"top": 20, "sortBy": "cpu", "reset": false},
+     * entries can be sorted by "cpu", "wall", "alloc", "native" or "calls"
+     *
+     * @param options query options
+     * @return costs JSON
+     */
+    sl::json::value top(const sl::json::value& options);
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_cost_tracker> shared_cost_tracker();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_COST_TRACKER_HPP */
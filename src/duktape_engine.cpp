@@ -24,9 +24,17 @@
 
 #include "duktape_engine.hpp"
 
+#include <cmath>
 #include <cstring>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "duktape.h"
 
@@ -41,7 +49,28 @@
 #include "wilton/support/exception.hpp"
 #include "wilton/support/logging.hpp"
 
+#include "duktape_allocator.hpp"
+#include "duktape_async_calls.hpp"
+#include "duktape_callback_info.hpp"
+#include "duktape_cbor.hpp"
+#include "duktape_channel_registry.hpp"
+#include "duktape_config.hpp"
+#include "duktape_cost_tracker.hpp"
 #include "duktape_debug_transport.hpp"
+#include "duktape_event_loop.hpp"
+#include "duktape_function_registry.hpp"
+#include "duktape_heap_census.hpp"
+#include "duktape_placement.hpp"
+#include "duktape_platform.hpp"
+#include "duktape_prepared_handlers.hpp"
+#include "duktape_primitives.hpp"
+#include "duktape_shared_cache.hpp"
+#include "duktape_source_loader.hpp"
+#include "duktape_stream_registry.hpp"
+#include "duktape_teardown.hpp"
+#include "duktape_tracer.hpp"
+#include "duktape_watchdog.hpp"
+#include "duktape_worker_pool.hpp"
 
 namespace wilton {
 namespace duktape {
@@ -52,6 +81,73 @@ const std::string st_prefix = "caught invalid c++ std::exception '";
 const std::string st_postfix = "' (perhaps thrown by user code)";
 const std::string st_anon = "at [anon]";
 const std::string st_reqjs = "/require.js:";
+const char* native_function_key = "\xff" "wiltonNativeFunction";
+const char* globals_baseline_key = "\xff" "wiltonGlobalsBaseline";
+const char* event_loop_key = "\xff" "wiltonEventLoop";
+const char* event_callbacks_key = "\xff" "wiltonEventCallbacks";
+const char* watchdog_key = "\xff" "wiltonWatchdog";
+const char* callback_dispatch_key = "\xff" "wiltonCallbackDispatch";
+const char* handler_resolve_key = "\xff" "wiltonHandlerResolve";
+const char* handler_invoke_key = "\xff" "wiltonHandlerInvoke";
+const char* prepared_handlers_key = "\xff" "wiltonPreparedHandlers";
+const char* native_time_key = "\xff" "wiltonNativeTime";
+const char* engine_key = "\xff" "wiltonEngine";
+const char* abort_error_key = "\xff" "wiltonAbortError";
+const char* invalid_args_error_key = "\xff" "wiltonInvalidArgsError";
+const char* original_fin_key = "\xff" "wiltonOriginalFin";
+const char* has_finalizers_key = "\xff" "wiltonHasFinalizers";
+// same limit as browsers apply to timer delays, about 24.8 days
+const uint64_t max_timeout_millis = 0x7fffffff;
+const uint64_t max_safe_integer = 9007199254740991;
+// stream reads are not pre-allocated beyond this size, callers read in a loop
+const duk_int_t max_stream_chunk_len = 1 << 20;
+const duk_idx_t native_function_max_stack_args = 8;
+
+// runs already parsed callback script, same as WILTON_run does after JSON.parse,
+// modules are loaded synchronously, so require callback is called before return
+const std::string callback_dispatch_code = std::string() +
+        "(function(cs) {\n" +
+        "    if (null === cs || 'object' !== typeof(cs) || 'string' !== typeof(cs.module) || 0 === cs.module.length) {\n" +
+        "        throw new Error('Invalid callback script, module name must be specified');\n" +
+        "    }\n" +
+        "    var res = null;\n" +
+        "    require([cs.module], function(mod) {\n" +
+        "        if ('string' === typeof(cs.func) && cs.func.length > 0) {\n" +
+        "            if ('function' !== typeof(mod[cs.func])) {\n" +
+        "                throw new Error('Invalid function specified, module: [' + cs.module + '], func: [' + cs.func + ']');\n" +
+        "            }\n" +
+        "            var args = cs.args instanceof Array ? cs.args : [];\n" +
+        "            res = mod[cs.func].apply(mod, args);\n" +
+        "        }\n" +
+        "    });\n" +
+        "    return res;\n" +
+        "})";
+
+// returns [fun, module] pair, that is cached per engine
+const std::string handler_resolve_code = std::string() +
+        "(function(module, func) {\n" +
+        "    var res = null;\n" +
+        "    require([module], function(mod) {\n" +
+        "        if ('function' !== typeof(mod[func])) {\n" +
+        "            throw new Error('Invalid function specified, module: [' + module + '], func: [' + func + ']');\n" +
+        "        }\n" +
+        "        res = [mod[func], mod];\n" +
+        "    });\n" +
+        "    return res;\n" +
+        "})";
+
+// JSON arguments are passed as string, results are returned the same way as from WILTON_run
+const std::string handler_invoke_code = std::string() +
+        "(function(fun, mod, args) {\n" +
+        "    if ('string' !== typeof(args)) {\n" +
+        "        return fun.apply(mod, args);\n" +
+        "    }\n" +
+        "    var res = fun.apply(mod, args.length > 0 ? JSON.parse(args) : []);\n" +
+        "    if (null === res || undefined === res || 'string' === typeof(res)) {\n" +
+        "        return res;\n" +
+        "    }\n" +
+        "    return JSON.stringify(res);\n" +
+        "})";
 
 // duktape debug port offset iterator
 std::atomic<uint16_t> engine_counter; // zero initialization by default
@@ -77,10 +173,32 @@ void fatal_handler(duk_context* , duk_errcode_t code, const char* msg) {
             " code: [" + sl::support::to_string(code) + "], message: [" + msg + "]"));
 }
 
-void ctx_deleter(duk_context* ctx) {
-    if (nullptr != ctx) {
-        duk_destroy_heap(ctx);
-    }
+// heap may be destroyed on the teardown thread after the engine is gone,
+// so objects, that are referenced from the heap, are handed over with it
+std::function<void(duk_context*)> make_ctx_deleter(std::shared_ptr<duktape_engine_placement> placement,
+        std::shared_ptr<duktape_event_loop> event_loop, std::shared_ptr<duktape_watched_engine> watched) {
+    auto teardown = shared_teardown();
+    return [teardown, placement, event_loop, watched](duk_context* ctx) {
+        if (nullptr == ctx) {
+            return;
+        }
+        // stash pointed to the engine member, finalizers may still clear timers
+        auto loop_holder = std::make_shared<std::shared_ptr<duktape_event_loop>>(event_loop);
+        duk_push_global_stash(ctx);
+        duk_push_pointer(ctx, static_cast<void*> (loop_holder.get()));
+        duk_put_prop_string(ctx, -2, event_loop_key);
+        // engine member, already destroyed
+        duk_push_pointer(ctx, nullptr);
+        duk_put_prop_string(ctx, -2, native_time_key);
+        duk_get_prop_string(ctx, -1, has_finalizers_key);
+        bool has_finalizers = duk_get_boolean(ctx, -1) ? true : false;
+        duk_pop_2(ctx);
+        auto deps = duktape_heap_dependencies();
+        deps.emplace_back(placement);
+        deps.emplace_back(loop_holder);
+        deps.emplace_back(watched);
+        teardown->destroy_heap(ctx, std::move(deps), has_finalizers);
+    };
 }
 
 void pop_stack(duk_context* ctx) {
@@ -125,26 +243,59 @@ std::string format_stacktrace(duk_context* ctx) {
     return res;
 }
 
-duk_ret_t load_func(duk_context* ctx) {
-    auto path = std::string();
+// errors with fixed messages are created once per engine, they are thrown
+// repeatedly from an aborted call, that keeps hitting native boundaries
+void push_cached_error(duk_context* ctx, const char* key) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, key);
+    duk_remove(ctx, -2);
+}
+
+// called on native call boundaries, JS stack can only be captured there,
+// pushes an error and returns true if the call must be aborted
+bool check_watchdog(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, watchdog_key);
+    auto watched = static_cast<duktape_watched_engine*> (duk_get_pointer(ctx, -1));
+    duk_pop_2(ctx);
+    if (nullptr == watched) {
+        return false;
+    }
+    if (watched->capture_requested.exchange(false, std::memory_order_relaxed)) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s", "Watchdog stack capture");
+        duk_get_prop_string(ctx, -1, "stack");
+        watched->set_captured_stack(std::string(duk_safe_to_string(ctx, -1)));
+        duk_pop_2(ctx);
+    }
+    // flag is kept, so the call cannot continue after catching the error
+    if (watched->abort_requested.load(std::memory_order_relaxed)) {
+        push_cached_error(ctx, abort_error_key);
+        return true;
+    }
+    return false;
+}
+
+// Errors are reported with Duktape error objects pushed on top of the stack,
+// callers throw them only after all C++ objects of these functions are destroyed
+
+bool load_script(duk_context* ctx) {
+    size_t path_len;
+    const char* path_ptr = duk_get_lstring(ctx, 0, std::addressof(path_len));
+    if (nullptr == path_ptr) {
+        push_cached_error(ctx, invalid_args_error_key);
+        return false;
+    }
+    if (check_watchdog(ctx)) {
+        return false;
+    }
     try {
-        size_t path_len;
-        const char* path_ptr = duk_get_lstring(ctx, 0, std::addressof(path_len));
-        if (nullptr == path_ptr) {
-            throw support::exception(TRACEMSG("Invalid arguments specified"));
-        }
-        path = std::string(path_ptr, path_len);
-        // load code
-        char* code = nullptr;
-        int code_len = 0;
-        auto err_load = wilton_load_resource(path.c_str(), static_cast<int>(path.length()),
-                std::addressof(code), std::addressof(code_len));
-        if (nullptr != err_load) {
-            support::throw_wilton_error(err_load, TRACEMSG(err_load));
-        }
-        if (0 == code_len) {
-            throw support::exception(TRACEMSG(
-                    "\nInvalid empty source code loaded, path: [" + path + "]").c_str());
+        auto path = std::string(path_ptr, path_len);
+        // load code, source memory is either mapped or shared between engines
+        auto source = shared_source_loader()->load(path);
+        if (0 == source->size()) {
+            duk_push_error_object(ctx, DUK_ERR_ERROR,
+                    "Invalid empty source code loaded, path: [%s]", path.c_str());
+            return false;
         }
         wilton::support::log_debug("wilton.engine.duktape.eval",
                 "Evaluating source file, path: [" + path + "] ...");
@@ -152,35 +303,91 @@ duk_ret_t load_func(duk_context* ctx) {
         // compile source
         auto path_short = support::script_engine_map_detail::shorten_script_path(path);
         wilton::support::log_debug("wilton.engine.duktape.eval", "loaded file short path: [" + path_short + "]");
+        duktape_trace_span span("compile", path_short.c_str(), path_short.length(), source->size());
 
-        duk_push_lstring(ctx, code, code_len);
-        wilton_free(code);
+        // compiled directly from source memory without creating a JS string
         duk_push_lstring(ctx, path_short.c_str(), path_short.length());
-        auto err = duk_pcompile(ctx, DUK_COMPILE_EVAL);
+        auto err = duk_pcompile_lstring_filename(ctx, DUK_COMPILE_EVAL, source->data(), source->size());
+        source.reset();
         if (DUK_EXEC_SUCCESS == err) {
             err = duk_pcall(ctx, 0);
         }
 
         if (DUK_EXEC_SUCCESS != err) {
-            std::string msg = format_stacktrace(ctx);
-            duk_pop(ctx);
-            throw support::exception(TRACEMSG(msg + "\nCall error"));
-        } else {
-            wilton::support::log_debug("wilton.engine.duktape.eval", "Eval complete");
-            duk_pop(ctx);
-            duk_push_true(ctx);
+            // compilation or module error is rethrown as is, with its own stack
+            return false;
         }
+        wilton::support::log_debug("wilton.engine.duktape.eval", "Eval complete");
+        duk_pop(ctx);
+        duk_push_true(ctx);
+        return true;
+    } catch (const std::exception& e) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s\nError loading script, path: [%.*s]",
+                e.what(), static_cast<int> (path_len), path_ptr);
+        return false;
+    }
+}
 
-        return 1;
+duk_ret_t load_func(duk_context* ctx) {
+    if (!load_script(ctx)) {
+        duk_throw(ctx);
+    }
+    return 1;
+}
+
+bool perform_native_call(duk_context* ctx, const char* name, size_t name_len,
+        const char* input, size_t input_len) {
+    char* out = nullptr;
+    int out_len = 0;
+    duktape_trace_span span("native", name, name_len, input_len);
+    wilton::support::log_debug(std::string("wilton.wiltoncall.") + name,
+            "Performing a call, input length: [" + sl::support::to_string(input_len) + "] ...");
+    auto err = wiltoncall(name, static_cast<int> (name_len), input, static_cast<int> (input_len),
+            std::addressof(out), std::addressof(out_len));
+    wilton::support::log_debug(std::string("wilton.wiltoncall.") + name,
+            "Call complete, result: [" + (nullptr != err ? std::string(err) : "") + "]");
+    if (nullptr != err) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s\n'wiltoncall' error for name: [%s]", err, name);
+        wilton_free(err);
+        return false;
+    }
+    span.set_output_len(static_cast<size_t> (out_len));
+    if (nullptr == out) {
+        duk_push_null(ctx);
+        return true;
+    }
+    auto deferred = sl::support::defer([out]() STATICLIB_NOEXCEPT {
+        wilton_free(out);
+    });
+    auto out_span = sl::io::span<const char>(out, static_cast<size_t> (out_len));
+    if (!is_cbor_payload(out_span)) {
+        duk_push_lstring(ctx, out, out_len);
+        return true;
+    }
+    // results, negotiated by native module as CBOR, are passed to JS as values
+    try {
+        cbor_decode(ctx, out_span);
+        return true;
     } catch (const std::exception& e) {
-        throw support::exception(TRACEMSG(e.what() + 
-                "\nError loading script, path: [" + path + "]").c_str());
-    } catch (...) {
-        throw support::exception(TRACEMSG(
-                "Error(...) loading script, path: [" + path + "]").c_str());
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s\n'wiltoncall' result error for name: [%s]", e.what(), name);
+        return false;
     }
 }
 
+uint64_t current_time_micros() {
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// set only when cost attribution is enabled
+duktape_native_time* get_native_time(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, native_time_key);
+    auto res = static_cast<duktape_native_time*> (duk_get_pointer(ctx, -1));
+    duk_pop_2(ctx);
+    return res;
+}
+
 duk_ret_t wiltoncall_func(duk_context* ctx) {
     size_t name_len;
     const char* name = duk_get_lstring(ctx, 0, std::addressof(name_len));
@@ -190,31 +397,810 @@ duk_ret_t wiltoncall_func(duk_context* ctx) {
     }
     size_t input_len;
     const char* input = duk_get_lstring(ctx, 1, std::addressof(input_len));
+    if (nullptr == input) {
+        // binary input, e.g. from WILTON_cbor_encode
+        input = static_cast<const char*> (duk_get_buffer_data(ctx, 1, std::addressof(input_len)));
+    }
+    if (nullptr == input) {
+        input = "";
+        input_len = 0;
+    }
+    if (check_watchdog(ctx)) {
+        duk_throw(ctx);
+    }
+    auto native_time = get_native_time(ctx);
+    auto start = nullptr != native_time ? current_time_micros() : 0;
+    auto success = perform_native_call(ctx, name, name_len, input, input_len);
+    if (nullptr != native_time) {
+        native_time->micros += current_time_micros() - start;
+        native_time->calls += 1;
+    }
+    if (!success || check_watchdog(ctx)) {
+        duk_throw(ctx);
+    }
+    return 1;
+}
+
+// NaN, infinite and out of range numbers are not converted directly,
+// as such conversions are undefined
+uint64_t clamp_to_uint64(double num, uint64_t max) {
+    if (!(num > 0)) {
+        return 0;
+    }
+    if (num >= static_cast<double> (max)) {
+        return max;
+    }
+    return static_cast<uint64_t> (num);
+}
+
+// negative and infinite timeouts mean waiting without timeout, NaN means no wait
+int64_t get_timeout_millis(duk_context* ctx, duk_idx_t idx) {
+    if (duk_is_null_or_undefined(ctx, idx)) {
+        return -1;
+    }
+    auto num = duk_get_number(ctx, idx);
+    if (num < 0 || std::isinf(num)) {
+        return -1;
+    }
+    return static_cast<int64_t> (clamp_to_uint64(num, max_timeout_millis));
+}
+
+// invalid values become zero, that is never used for handles and timer ids
+uint64_t get_handle(duk_context* ctx, duk_idx_t idx) {
+    return clamp_to_uint64(duk_get_number(ctx, idx), max_safe_integer);
+}
+
+// identifies the engine, that owns the context
+const void* get_engine_key(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, engine_key);
+    auto res = duk_get_pointer(ctx, -1);
+    duk_pop_2(ctx);
+    return res;
+}
+
+// [name, input] -> [handle]
+duk_ret_t wiltoncall_start_func(duk_context* ctx) {
+    size_t name_len;
+    const char* name = duk_get_lstring(ctx, 0, std::addressof(name_len));
+    if (nullptr == name) {
+        throw support::exception(TRACEMSG("Invalid call name specified"));
+    }
+    size_t input_len;
+    const char* input = duk_get_lstring(ctx, 1, std::addressof(input_len));
     if (nullptr == input) {
         input = "";
         input_len = 0;
     }
-    char* out = nullptr;
-    int out_len = 0;
-    wilton::support::log_debug(std::string("wilton.wiltoncall.") + name,
-            "Performing a call, input length: [" + sl::support::to_string(input_len) + "] ...");
-    auto err = wiltoncall(name, static_cast<int> (name_len), input, static_cast<int> (input_len),
-            std::addressof(out), std::addressof(out_len));
-    wilton::support::log_debug(std::string("wilton.wiltoncall.") + name,
-            "Call complete, result: [" + (nullptr != err ? std::string(err) : "") + "]");
-    if (nullptr == err) {
-        if (nullptr != out) {
-            duk_push_lstring(ctx, out, out_len);
-            wilton_free(out);
+    auto calls = shared_async_calls();
+    auto handle = calls->start(get_engine_key(ctx), std::string(name, name_len), std::string(input, input_len));
+    duk_push_number(ctx, static_cast<duk_double_t> (handle));
+    return 1;
+}
+
+bool wait_async_call(duk_context* ctx) {
+    auto handle = get_handle(ctx, 0);
+    auto timeout = get_timeout_millis(ctx, 1);
+    try {
+        auto result = duktape_async_result();
+        auto calls = shared_async_calls();
+        auto complete = calls->wait(get_engine_key(ctx), handle, timeout, result);
+        if (!complete) {
+            duk_push_undefined(ctx);
+        } else if (result.has_data) {
+            duk_push_lstring(ctx, result.data.c_str(), result.data.length());
         } else {
             duk_push_null(ctx);
         }
-        return 1;
+        return true;
+    } catch (const std::exception& e) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s", e.what());
+        return false;
+    }
+}
+
+// [handle, timeout] -> [result], undefined result on timeout
+duk_ret_t wiltoncall_wait_func(duk_context* ctx) {
+    if (!wait_async_call(ctx) || check_watchdog(ctx)) {
+        duk_throw(ctx);
+    }
+    return 1;
+}
+
+std::shared_ptr<duktape_event_loop> get_event_loop(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, event_loop_key);
+    auto ptr = static_cast<std::shared_ptr<duktape_event_loop>*> (duk_get_pointer(ctx, -1));
+    duk_pop_2(ctx);
+    if (nullptr == ptr) throw support::exception(TRACEMSG(
+            "Event loop is not initialized"));
+    return *ptr;
+}
+
+void put_event_callback(duk_context* ctx, uint64_t id, duk_idx_t fun_idx) {
+    fun_idx = duk_normalize_index(ctx, fun_idx);
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, event_callbacks_key);
+    duk_push_number(ctx, static_cast<duk_double_t> (id));
+    duk_dup(ctx, fun_idx);
+    duk_put_prop(ctx, -3);
+    duk_pop_2(ctx);
+}
+
+// pushes callback, or undefined if it was removed
+void get_event_callback(duk_context* ctx, uint64_t id, bool remove) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, event_callbacks_key);
+    duk_push_number(ctx, static_cast<duk_double_t> (id));
+    duk_get_prop(ctx, -2);
+    if (remove) {
+        duk_push_number(ctx, static_cast<duk_double_t> (id));
+        duk_del_prop(ctx, -3);
+    }
+    duk_remove(ctx, -2);
+    duk_remove(ctx, -2);
+}
+
+duk_ret_t set_timer(duk_context* ctx, bool repeat) {
+    if (!duk_is_function(ctx, 0)) throw support::exception(TRACEMSG(
+            "Invalid timer callback specified"));
+    // NaN and negative delays are treated as zero
+    auto delay_millis = clamp_to_uint64(duk_get_number(ctx, 1), max_timeout_millis);
+    auto loop = get_event_loop(ctx);
+    auto id = loop->add_timer(delay_millis, repeat);
+    put_event_callback(ctx, id, 0);
+    duk_push_number(ctx, static_cast<duk_double_t> (id));
+    return 1;
+}
+
+// [callback, delay] -> [id]
+duk_ret_t set_timeout_func(duk_context* ctx) {
+    return set_timer(ctx, false);
+}
+
+// [callback, interval] -> [id]
+duk_ret_t set_interval_func(duk_context* ctx) {
+    return set_timer(ctx, true);
+}
+
+// [id] -> []
+duk_ret_t clear_timer_func(duk_context* ctx) {
+    if (!duk_is_number(ctx, 0)) {
+        return 0;
+    }
+    auto id = get_handle(ctx, 0);
+    auto loop = get_event_loop(ctx);
+    if (loop->cancel_timer(id)) {
+        get_event_callback(ctx, id, true);
+        duk_pop(ctx);
+    }
+    return 0;
+}
+
+// [name, input, callback] -> [], callback receives [error, result]
+duk_ret_t wiltoncall_async_func(duk_context* ctx) {
+    size_t name_len;
+    const char* name = duk_get_lstring(ctx, 0, std::addressof(name_len));
+    if (nullptr == name) {
+        throw support::exception(TRACEMSG("Invalid call name specified"));
+    }
+    size_t input_len;
+    const char* input = duk_get_lstring(ctx, 1, std::addressof(input_len));
+    if (nullptr == input) {
+        input = "";
+        input_len = 0;
+    }
+    if (!duk_is_function(ctx, 2)) throw support::exception(TRACEMSG(
+            "Invalid call callback specified"));
+    auto loop = get_event_loop(ctx);
+    auto id = loop->add_pending_call();
+    put_event_callback(ctx, id, 2);
+    auto name_ptr = std::make_shared<std::string>(name, name_len);
+    auto input_ptr = std::make_shared<std::string>(input, input_len);
+    auto task = [loop, id, name_ptr, input_ptr] {
+        try {
+            auto res = perform_wiltoncall(*name_ptr, *input_ptr);
+            loop->complete_call(id, false, res.has_data, std::move(res.data));
+        } catch (const std::exception& e) {
+            loop->complete_call(id, true, false, std::string(e.what()));
+        }
+    };
+    auto pool = shared_worker_pool();
+    if (pool->is_worker_thread()) {
+        // pool thread must not wait for the pool, callback still runs from the loop
+        task();
+        return 0;
+    }
+    try {
+        pool->submit(task);
+    } catch (const std::exception& e) {
+        // pending call must be completed to let the loop drain
+        loop->complete_call(id, true, false, std::string(e.what()));
+    }
+    return 0;
+}
+
+void run_loop_event(duk_context* ctx, const duktape_loop_event& ev) {
+    get_event_callback(ctx, ev.id, !ev.repeat);
+    if (!duk_is_function(ctx, -1)) {
+        // cleared from the other callback
+        duk_pop(ctx);
+        return;
+    }
+    duk_int_t err = DUK_EXEC_SUCCESS;
+    if (ev.timer) {
+        err = duk_pcall(ctx, 0);
     } else {
-        auto msg = TRACEMSG(err + "\n'wiltoncall' error for name: [" + name + "]");
+        if (ev.failed) {
+            duk_push_lstring(ctx, ev.data.c_str(), ev.data.length());
+            duk_push_null(ctx);
+        } else {
+            duk_push_null(ctx);
+            if (ev.has_data) {
+                duk_push_lstring(ctx, ev.data.c_str(), ev.data.length());
+            } else {
+                duk_push_null(ctx);
+            }
+        }
+        err = duk_pcall(ctx, 2);
+    }
+    if (DUK_EXEC_SUCCESS != err) {
+        wilton::support::log_error("wilton.engine.duktape.loop",
+                TRACEMSG(format_stacktrace(ctx) + "\nEvent callback error"));
+    }
+    duk_pop(ctx);
+}
+
+// returns true if no timers and pending calls are left
+bool run_event_loop(duk_context* ctx, int64_t timeout_millis) {
+    auto loop = get_event_loop(ctx);
+    auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        auto remaining = static_cast<int64_t> (-1);
+        if (timeout_millis >= 0) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            if (elapsed > timeout_millis) {
+                return false;
+            }
+            remaining = timeout_millis - static_cast<int64_t> (elapsed);
+        }
+        auto ev = duktape_loop_event();
+        if (!loop->next_event(remaining, ev)) {
+            return !loop->has_pending();
+        }
+        run_loop_event(ctx, ev);
+    }
+}
+
+// [timeout] -> [drained]
+duk_ret_t run_event_loop_func(duk_context* ctx) {
+    auto timeout = get_timeout_millis(ctx, 0);
+    auto drained = run_event_loop(ctx, timeout);
+    duk_push_boolean(ctx, drained);
+    return 1;
+}
+
+class parallel_map_part {
+public:
+    uint64_t handle;
+    uint32_t from;
+    uint32_t to;
+
+    parallel_map_part(uint64_t handle, uint32_t from, uint32_t to) :
+    handle(handle),
+    from(from),
+    to(to) { }
+};
+
+// each part is passed to the function as an array of items,
+// function must return an array of results of the same size
+// [module, func, items, options] -> [results]
+duk_ret_t parallel_map_func(duk_context* ctx) {
+    const char* module = duk_get_string(ctx, 0);
+    const char* func = duk_get_string(ctx, 1);
+    if (nullptr == module || nullptr == func) {
+        throw support::exception(TRACEMSG("Invalid module or function name specified"));
+    }
+    if (!duk_is_array(ctx, 2)) {
+        throw support::exception(TRACEMSG("Invalid items specified, array expected"));
+    }
+    auto pool = shared_worker_pool();
+    if (pool->is_worker_thread()) throw support::exception(TRACEMSG(
+            "Parallel map cannot be called from the worker pool thread"));
+    auto len = static_cast<uint32_t> (duk_get_length(ctx, 2));
+    auto parts = pool->threads_count();
+    if (duk_is_object(ctx, 3)) {
+        duk_get_prop_string(ctx, 3, "parts");
+        if (duk_is_number(ctx, -1)) {
+            parts = std::max(duk_get_uint(ctx, -1), static_cast<duk_uint_t> (1));
+        }
+        duk_pop(ctx);
+    }
+    parts = std::min(parts, len);
+
+    // one callback script per part
+    auto calls = shared_async_calls();
+    auto owner = get_engine_key(ctx);
+    auto handles = std::vector<parallel_map_part>();
+    for (uint32_t p = 0; p < parts; p++) {
+        auto from = static_cast<uint32_t> (static_cast<uint64_t> (len) * p / parts);
+        auto to = static_cast<uint32_t> (static_cast<uint64_t> (len) * (p + 1) / parts);
+        duk_push_object(ctx);
+        duk_push_string(ctx, module);
+        duk_put_prop_string(ctx, -2, "module");
+        duk_push_string(ctx, func);
+        duk_put_prop_string(ctx, -2, "func");
+        duk_push_array(ctx);
+        duk_push_array(ctx);
+        for (uint32_t i = from; i < to; i++) {
+            duk_get_prop_index(ctx, 2, i);
+            duk_put_prop_index(ctx, -2, i - from);
+        }
+        duk_put_prop_index(ctx, -2, 0);
+        duk_put_prop_string(ctx, -2, "args");
+        duk_json_encode(ctx, -1);
+        size_t script_len = 0;
+        const char* script = duk_get_lstring(ctx, -1, std::addressof(script_len));
+        try {
+            auto ha = calls->start(owner, "runscript_duktape", std::string(script, script_len));
+            handles.emplace_back(ha, from, to);
+        } catch (...) {
+            // started parts may still use the items, results are discarded
+            for (auto& pa : handles) {
+                auto res = duktape_async_result();
+                try {
+                    calls->wait(owner, pa.handle, -1, res);
+                } catch (const std::exception&) {
+                    // ignore
+                }
+            }
+            throw;
+        }
+        duk_pop(ctx);
+    }
+
+    // all parts are waited for even if one of them failed
+    auto results = std::vector<duktape_async_result>();
+    auto error = std::string();
+    for (auto& pa : handles) {
+        auto res = duktape_async_result();
+        try {
+            calls->wait(owner, pa.handle, -1, res);
+        } catch (const std::exception& e) {
+            if (error.empty()) {
+                error = e.what();
+            }
+        }
+        results.emplace_back(std::move(res));
+    }
+    if (!error.empty()) {
+        throw support::exception(TRACEMSG(error + "\nParallel map error"));
+    }
+
+    duk_push_array(ctx);
+    duk_uarridx_t idx = 0;
+    for (size_t p = 0; p < results.size(); p++) {
+        auto& res = results[p];
+        auto& pa = handles[p];
+        if (!res.has_data) throw support::exception(TRACEMSG(
+                "Invalid null result of parallel map part, function: [" + func + "]"));
+        duk_push_lstring(ctx, res.data.c_str(), res.data.length());
+        duk_json_decode(ctx, -1);
+        if (!duk_is_array(ctx, -1)) throw support::exception(TRACEMSG(
+                "Invalid result of parallel map part, array expected, function: [" + func + "]"));
+        auto res_len = static_cast<uint32_t> (duk_get_length(ctx, -1));
+        if (res_len != pa.to - pa.from) throw support::exception(TRACEMSG(
+                "Invalid result of parallel map part, size mismatch, function: [" + func + "]," +
+                " part: [" + sl::support::to_string(p) + "]," +
+                " items: [" + sl::support::to_string(pa.to - pa.from) + "]," +
+                " results: [" + sl::support::to_string(res_len) + "]"));
+        for (uint32_t i = 0; i < res_len; i++) {
+            duk_get_prop_index(ctx, -1, i);
+            duk_put_prop_index(ctx, -3, idx++);
+        }
+        duk_pop(ctx);
+    }
+    return 1;
+}
+
+sl::io::span<const char> get_chunk(duk_context* ctx, duk_idx_t idx) {
+    if (DUK_TYPE_BUFFER == duk_get_type(ctx, idx) || DUK_TYPE_OBJECT == duk_get_type(ctx, idx)) {
+        duk_size_t len = 0;
+        void* data = duk_get_buffer_data(ctx, idx, std::addressof(len));
+        if (nullptr != data) {
+            return sl::io::span<const char>(static_cast<const char*> (data), len);
+        }
+    }
+    size_t len = 0;
+    const char* str = duk_get_lstring(ctx, idx, std::addressof(len));
+    if (nullptr == str) {
+        throw support::exception(TRACEMSG("Invalid chunk specified, string or buffer expected"));
+    }
+    return sl::io::span<const char>(str, len);
+}
+
+duk_ret_t stream_write_func(duk_context* ctx) {
+    size_t name_len;
+    const char* name = duk_get_lstring(ctx, 0, std::addressof(name_len));
+    if (nullptr == name) {
+        throw support::exception(TRACEMSG("Invalid sink name specified"));
+    }
+    auto chunk = get_chunk(ctx, 1);
+    auto registry = shared_stream_registry();
+    registry->write_to_sink(std::string(name, name_len), chunk);
+    return 0;
+}
+
+duk_ret_t stream_read_func(duk_context* ctx) {
+    size_t name_len;
+    const char* name = duk_get_lstring(ctx, 0, std::addressof(name_len));
+    if (nullptr == name) {
+        throw support::exception(TRACEMSG("Invalid source name specified"));
+    }
+    auto max_len = duk_get_int(ctx, 1);
+    if (max_len <= 0) {
+        throw support::exception(TRACEMSG("Invalid max chunk length specified,"
+                " length: [" + sl::support::to_string(max_len) + "]"));
+    }
+    max_len = std::min(max_len, max_stream_chunk_len);
+    // data is read directly into JS buffer, that is shrunk afterwards
+    auto buf = static_cast<char*> (duk_push_dynamic_buffer(ctx, static_cast<duk_size_t> (max_len)));
+    auto registry = shared_stream_registry();
+    auto read = registry->read_from_source(std::string(name, name_len),
+            sl::io::span<char>(buf, static_cast<size_t> (max_len)));
+    if (0 == read) {
+        duk_pop(ctx);
+        duk_push_null(ctx);
+    } else if (read < static_cast<size_t> (max_len)) {
+        duk_resize_buffer(ctx, -1, read);
+    }
+    return 1;
+}
+
+void push_data(duk_context* ctx, const std::string& data, bool binary) {
+    if (binary) {
+        void* buf = duk_push_fixed_buffer(ctx, data.length());
+        if (data.length() > 0) {
+            std::memcpy(buf, data.data(), data.length());
+        }
+    } else {
+        duk_push_lstring(ctx, data.data(), data.length());
+    }
+}
+
+std::string get_channel_name(duk_context* ctx) {
+    size_t name_len;
+    const char* name = duk_get_lstring(ctx, 0, std::addressof(name_len));
+    if (nullptr == name) {
+        throw support::exception(TRACEMSG("Invalid channel name specified"));
+    }
+    return std::string(name, name_len);
+}
+
+duk_ret_t channel_create_func(duk_context* ctx) {
+    auto name = get_channel_name(ctx);
+    auto capacity = duk_get_uint(ctx, 1);
+    auto registry = shared_channel_registry();
+    registry->create(name, static_cast<uint32_t> (capacity));
+    return 0;
+}
+
+duk_ret_t channel_close_func(duk_context* ctx) {
+    auto name = get_channel_name(ctx);
+    auto registry = shared_channel_registry();
+    registry->close(name);
+    return 0;
+}
+
+duk_ret_t channel_send_func(duk_context* ctx) {
+    auto name = get_channel_name(ctx);
+    bool binary = DUK_TYPE_STRING != duk_get_type(ctx, 1);
+    auto chunk = get_chunk(ctx, 1);
+    // the only copy on the sender side, message is moved afterwards
+    auto message = duktape_channel_message(std::string(chunk.data(), chunk.size()), binary);
+    auto timeout = get_timeout_millis(ctx, 2);
+    auto registry = shared_channel_registry();
+    bool sent = registry->send(name, message, timeout);
+    duk_push_boolean(ctx, sent);
+    return 1;
+}
+
+// [name, timeout] -> [message], null on timeout,
+// false when channel is closed and drained
+duk_ret_t channel_receive_func(duk_context* ctx) {
+    auto name = get_channel_name(ctx);
+    auto timeout = get_timeout_millis(ctx, 1);
+    auto message = duktape_channel_message();
+    auto registry = shared_channel_registry();
+    auto status = registry->receive(name, message, timeout);
+    if (duktape_channel_status::received == status) {
+        // message is copied into the heap, external buffer over the message
+        // bytes cannot be freed safely: plain buffer escapes any wrapper object
+        // through valueOf() and typed array views, so its finalizer may run
+        // while the bytes are still referenced
+        push_data(ctx, message.data, message.binary);
+    } else if (duktape_channel_status::closed == status) {
+        duk_push_false(ctx);
+    } else {
+        duk_push_null(ctx);
+    }
+    return 1;
+}
+
+std::string get_cache_key(duk_context* ctx) {
+    size_t key_len;
+    const char* key = duk_get_lstring(ctx, 0, std::addressof(key_len));
+    if (nullptr == key) {
+        throw support::exception(TRACEMSG("Invalid cache key specified"));
+    }
+    return std::string(key, key_len);
+}
+
+duk_ret_t cache_get_func(duk_context* ctx) {
+    auto key = get_cache_key(ctx);
+    auto cache = shared_cache();
+    auto value = cache->get(key);
+    if (nullptr != value.get()) {
+        push_data(ctx, value->data, value->binary);
+    } else {
+        duk_push_null(ctx);
+    }
+    return 1;
+}
+
+duk_ret_t cache_put_func(duk_context* ctx) {
+    auto key = get_cache_key(ctx);
+    bool binary = DUK_TYPE_STRING != duk_get_type(ctx, 1);
+    auto chunk = get_chunk(ctx, 1);
+    auto value = std::make_shared<duktape_cache_value>(std::string(chunk.data(), chunk.size()), binary);
+    auto ttl = duk_is_null_or_undefined(ctx, 2) ? 0 : clamp_to_uint64(duk_get_number(ctx, 2), max_safe_integer);
+    auto cache = shared_cache();
+    bool cached = cache->put(key, std::move(value), ttl);
+    duk_push_boolean(ctx, cached);
+    return 1;
+}
+
+duk_ret_t cache_remove_func(duk_context* ctx) {
+    auto key = get_cache_key(ctx);
+    auto cache = shared_cache();
+    bool removed = cache->remove(key);
+    duk_push_boolean(ctx, removed);
+    return 1;
+}
+
+void read_native_value(duk_context* ctx, duk_idx_t idx, wilton_DuktapeValue& val) {
+    val.type = WILTON_DUKTAPE_TYPE_UNDEFINED;
+    val.number = 0;
+    val.data = nullptr;
+    val.data_len = 0;
+    duk_size_t len = 0;
+    switch (duk_get_type(ctx, idx)) {
+    case DUK_TYPE_NULL:
+        val.type = WILTON_DUKTAPE_TYPE_NULL;
+        break;
+    case DUK_TYPE_BOOLEAN:
+        val.type = WILTON_DUKTAPE_TYPE_BOOLEAN;
+        val.number = duk_get_boolean(ctx, idx) ? 1 : 0;
+        break;
+    case DUK_TYPE_NUMBER:
+        val.type = WILTON_DUKTAPE_TYPE_NUMBER;
+        val.number = duk_get_number(ctx, idx);
+        break;
+    case DUK_TYPE_STRING:
+        val.type = WILTON_DUKTAPE_TYPE_STRING;
+        val.data = duk_get_lstring(ctx, idx, std::addressof(len));
+        val.data_len = static_cast<int> (len);
+        break;
+    case DUK_TYPE_BUFFER:
+        val.type = WILTON_DUKTAPE_TYPE_BUFFER;
+        val.data = static_cast<const char*> (duk_get_buffer_data(ctx, idx, std::addressof(len)));
+        val.data_len = static_cast<int> (len);
+        break;
+    case DUK_TYPE_OBJECT: {
+        void* buf = duk_get_buffer_data(ctx, idx, std::addressof(len));
+        if (nullptr != buf) {
+            val.type = WILTON_DUKTAPE_TYPE_BUFFER;
+            val.data = static_cast<const char*> (buf);
+        } else {
+            // replaces the object on stack, so data stays valid during the call
+            duk_json_encode(ctx, idx);
+            val.data = duk_get_lstring(ctx, idx, std::addressof(len));
+            val.type = nullptr != val.data ? WILTON_DUKTAPE_TYPE_JSON : WILTON_DUKTAPE_TYPE_UNDEFINED;
+        }
+        val.data_len = static_cast<int> (len);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void push_native_value(duk_context* ctx, const wilton_DuktapeValue& val) {
+    auto len = val.data_len > 0 ? static_cast<duk_size_t> (val.data_len) : 0;
+    switch (val.type) {
+    case WILTON_DUKTAPE_TYPE_NULL:
+        duk_push_null(ctx);
+        break;
+    case WILTON_DUKTAPE_TYPE_BOOLEAN:
+        duk_push_boolean(ctx, 0 != val.number);
+        break;
+    case WILTON_DUKTAPE_TYPE_NUMBER:
+        duk_push_number(ctx, val.number);
+        break;
+    case WILTON_DUKTAPE_TYPE_STRING:
+        duk_push_lstring(ctx, nullptr != val.data ? val.data : "", len);
+        break;
+    case WILTON_DUKTAPE_TYPE_BUFFER: {
+        void* buf = duk_push_fixed_buffer(ctx, len);
+        if (len > 0) {
+            std::memcpy(buf, val.data, len);
+        }
+        break;
+    }
+    case WILTON_DUKTAPE_TYPE_JSON:
+        duk_push_lstring(ctx, nullptr != val.data ? val.data : "null", nullptr != val.data ? len : 4);
+        duk_json_decode(ctx, -1);
+        break;
+    default:
+        duk_push_undefined(ctx);
+    }
+}
+
+duk_ret_t native_function_dispatch(duk_context* ctx) {
+    auto nargs = duk_get_top(ctx);
+    duk_push_current_function(ctx);
+    duk_get_prop_string(ctx, -1, native_function_key);
+    auto fun = static_cast<duktape_native_function*> (duk_get_pointer(ctx, -1));
+    duk_pop_2(ctx);
+    if (nullptr == fun) {
+        throw support::exception(TRACEMSG("Invalid native function binding"));
+    }
+
+    // avoid heap allocation for the common case of few arguments
+    wilton_DuktapeValue stack_args[native_function_max_stack_args];
+    auto heap_args = std::vector<wilton_DuktapeValue>();
+    wilton_DuktapeValue* args = stack_args;
+    if (nargs > native_function_max_stack_args) {
+        heap_args.resize(static_cast<size_t> (nargs));
+        args = heap_args.data();
+    }
+    for (duk_idx_t i = 0; i < nargs; i++) {
+        read_native_value(ctx, i, args[i]);
+    }
+
+    wilton_DuktapeValue result;
+    std::memset(std::addressof(result), '\0', sizeof(result));
+    result.type = WILTON_DUKTAPE_TYPE_UNDEFINED;
+    auto err = fun->cb(fun->ctx, args, static_cast<int> (nargs), std::addressof(result));
+    auto deferred = sl::support::defer([&result]() STATICLIB_NOEXCEPT {
+        if (nullptr != result.data) {
+            wilton_free(const_cast<char*> (result.data));
+        }
+    });
+    if (nullptr != err) {
+        auto msg = TRACEMSG(err + "\nNative function error, name: [" + fun->name + "]");
         wilton_free(err);
         throw support::exception(msg);
     }
+    push_native_value(ctx, result);
+    return 1;
+}
+
+void bind_native_function(duk_context* ctx, duktape_native_function* fun) {
+    const std::string& name = fun->name;
+    duk_push_global_object(ctx);
+    size_t start = 0;
+    for (auto dot = name.find('.'); std::string::npos != dot; dot = name.find('.', start)) {
+        auto ns = name.substr(start, dot - start);
+        if (!duk_get_prop_string(ctx, -1, ns.c_str()) || !duk_is_object(ctx, -1)) {
+            duk_pop(ctx);
+            duk_push_object(ctx);
+            duk_dup_top(ctx);
+            duk_put_prop_string(ctx, -3, ns.c_str());
+        }
+        duk_remove(ctx, -2);
+        start = dot + 1;
+    }
+    duk_push_c_function(ctx, native_function_dispatch, DUK_VARARGS);
+    duk_push_pointer(ctx, static_cast<void*> (fun));
+    duk_put_prop_string(ctx, -2, native_function_key);
+    duk_put_prop_string(ctx, -2, name.substr(start).c_str());
+    duk_pop(ctx);
+}
+
+void record_globals_baseline(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_push_object(ctx);
+    duk_push_global_object(ctx);
+    duk_enum(ctx, -1, DUK_ENUM_OWN_PROPERTIES_ONLY | DUK_ENUM_INCLUDE_NONENUMERABLE);
+    while (duk_next(ctx, -1, 1)) {
+        // [stash baseline global enum key value]
+        duk_put_prop(ctx, -5);
+    }
+    duk_pop_2(ctx);
+    duk_put_prop_string(ctx, -2, globals_baseline_key);
+    duk_pop(ctx);
+}
+
+// [key] -> [undefined]
+duk_ret_t delete_global_prop(duk_context* ctx) {
+    duk_push_global_object(ctx);
+    duk_dup(ctx, 0);
+    duk_del_prop(ctx, -2);
+    return 0;
+}
+
+// [key value] -> [undefined]
+duk_ret_t put_global_prop(duk_context* ctx) {
+    duk_push_global_object(ctx);
+    duk_dup(ctx, 0);
+    duk_dup(ctx, 1);
+    duk_put_prop(ctx, -3);
+    return 0;
+}
+
+bool is_same_value(duk_context* ctx, duk_idx_t idx1, duk_idx_t idx2) {
+    if (duk_strict_equals(ctx, idx1, idx2)) {
+        return true;
+    }
+    if (duk_is_number(ctx, idx1) && duk_is_number(ctx, idx2)) {
+        auto num1 = duk_get_number(ctx, idx1);
+        auto num2 = duk_get_number(ctx, idx2);
+        // NaN
+        return num1 != num1 && num2 != num2;
+    }
+    return false;
+}
+
+// properties are restored one by one, non-configurable and non-writable ones
+// are skipped, so the reset itself never fails on user changes
+duk_ret_t reset_globals(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, globals_baseline_key);
+    auto baseline_idx = duk_normalize_index(ctx, -1);
+    duk_push_global_object(ctx);
+    auto global_idx = duk_normalize_index(ctx, -1);
+
+    // remove added
+    duk_enum(ctx, global_idx, DUK_ENUM_OWN_PROPERTIES_ONLY | DUK_ENUM_INCLUDE_NONENUMERABLE);
+    while (duk_next(ctx, -1, 0)) {
+        duk_dup_top(ctx);
+        if (!duk_has_prop(ctx, baseline_idx)) {
+            duk_dup_top(ctx);
+            if (DUK_EXEC_SUCCESS != duk_safe_call(ctx, delete_global_prop, 1, 1)) {
+                // declared with 'var'
+                duk_pop(ctx);
+                duk_dup_top(ctx);
+                duk_push_undefined(ctx);
+                duk_safe_call(ctx, put_global_prop, 2, 1);
+            }
+            duk_pop(ctx);
+        }
+        duk_pop(ctx);
+    }
+    duk_pop(ctx);
+
+    // restore changed and removed
+    duk_enum(ctx, baseline_idx, DUK_ENUM_OWN_PROPERTIES_ONLY | DUK_ENUM_INCLUDE_NONENUMERABLE);
+    while (duk_next(ctx, -1, 1)) {
+        // [enum key value]
+        duk_dup(ctx, -2);
+        duk_get_prop(ctx, global_idx);
+        bool same = is_same_value(ctx, -1, -2);
+        duk_pop(ctx);
+        if (!same) {
+            duk_dup(ctx, -2);
+            duk_dup(ctx, -2);
+            duk_safe_call(ctx, put_global_prop, 2, 1);
+            duk_pop(ctx);
+        }
+        duk_pop_2(ctx);
+    }
+    duk_pop(ctx);
+
+    duk_pop_3(ctx);
+    return 0;
 }
 
 void register_c_func(duk_context* ctx, const std::string& name, duk_c_function fun, duk_idx_t argnum) {
@@ -224,6 +1210,36 @@ void register_c_func(duk_context* ctx, const std::string& name, duk_c_function f
     duk_pop(ctx);
 }
 
+// [obj, finalizer] -> [result], marks the heap as having JS finalizers,
+// such heaps are not destroyed on the teardown thread
+duk_ret_t finalizer_func(duk_context* ctx) {
+    auto nargs = duk_get_top(ctx);
+    duk_push_global_stash(ctx);
+    if (nargs > 1) {
+        duk_push_true(ctx);
+        duk_put_prop_string(ctx, -2, has_finalizers_key);
+    }
+    duk_get_prop_string(ctx, -1, original_fin_key);
+    duk_remove(ctx, -2);
+    duk_insert(ctx, 0);
+    duk_call(ctx, nargs);
+    return 1;
+}
+
+void wrap_finalizer_setter(duk_context* ctx) {
+    duk_push_global_object(ctx);
+    duk_get_prop_string(ctx, -1, "Duktape");
+    if (duk_is_object(ctx, -1)) {
+        duk_push_global_stash(ctx);
+        duk_get_prop_string(ctx, -2, "fin");
+        duk_put_prop_string(ctx, -2, original_fin_key);
+        duk_pop(ctx);
+        duk_push_c_function(ctx, finalizer_func, DUK_VARARGS);
+        duk_put_prop_string(ctx, -2, "fin");
+    }
+    duk_pop_2(ctx);
+}
+
 void eval_js(duk_context* ctx, const char* code, size_t code_len) {
     auto err = duk_peval_lstring(ctx, code, code_len);
     if (DUK_EXEC_SUCCESS != err) {
@@ -233,18 +1249,61 @@ void eval_js(duk_context* ctx, const char* code, size_t code_len) {
     }
 }
 
-uint16_t get_debug_port_from_config() {
-    char* config = nullptr;
-    int config_len = 0;
+// [value pointer] -> [undefined], appends encoded value to std::string
+bool encode_cbor_result(duk_context* ctx) {
+    auto out = static_cast<std::string*> (duk_get_pointer(ctx, 1));
+    try {
+        cbor_encode(ctx, 0, *out);
+        return true;
+    } catch (const std::exception& e) {
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s", e.what());
+        return false;
+    }
+}
+
+duk_ret_t encode_cbor_result_func(duk_context* ctx) {
+    if (!encode_cbor_result(ctx)) {
+        duk_throw(ctx);
+    }
+    return 0;
+}
 
-    auto err_conf = wilton_config(std::addressof(config), std::addressof(config_len));
-    if (nullptr != err_conf) wilton::support::throw_wilton_error(err_conf, TRACEMSG(err_conf));
-    auto deferred = sl::support::defer([config] () STATICLIB_NOEXCEPT {
-        wilton_free(config);
-    }); // execute lambda on destruction
+// [stash] -> [stash fun module], handler is resolved on the first call in this engine
+void push_prepared_handler(duk_context* ctx, uint64_t handle) {
+    duk_get_prop_string(ctx, -1, prepared_handlers_key);
+    duk_push_number(ctx, static_cast<duk_double_t> (handle));
+    duk_get_prop(ctx, -2);
+    if (duk_is_undefined(ctx, -1)) {
+        duk_pop(ctx);
+        auto handler = shared_prepared_handlers()->find(handle);
+        duk_get_prop_string(ctx, -2, handler_resolve_key);
+        duk_push_lstring(ctx, handler->module.c_str(), handler->module.length());
+        duk_push_lstring(ctx, handler->func.c_str(), handler->func.length());
+        if (DUK_EXEC_SUCCESS != duk_pcall(ctx, 2)) {
+            throw support::exception(TRACEMSG(format_stacktrace(ctx) +
+                    "\nError resolving prepared handler, module: [" + handler->module + "]," +
+                    " func: [" + handler->func + "]"));
+        }
+        if (!duk_is_array(ctx, -1)) throw support::exception(TRACEMSG(
+                "Prepared handler module was not loaded, module: [" + handler->module + "]"));
+        duk_push_number(ctx, static_cast<duk_double_t> (handle));
+        duk_dup(ctx, -2);
+        duk_put_prop(ctx, -4);
+    }
+    // [stash handlers entry]
+    duk_get_prop_index(ctx, -1, 0);
+    duk_get_prop_index(ctx, -2, 1);
+    duk_remove(ctx, -3);
+    duk_remove(ctx, -3);
+}
 
+uint16_t get_debug_port_from_config() {
+#ifdef WILTON_DUKTAPE_NO_DEBUGGER
+    // performance build, Duktape is compiled without debugger support
+    return 0;
+#else // !WILTON_DUKTAPE_NO_DEBUGGER
     // get debug connection port
-    auto cf = sl::json::load({const_cast<const char*> (config), config_len});
+    auto cf = load_wilton_config();
     auto port_str = cf["debugConnectionPort"].as_string();
 
     if (!port_str.empty()) {
@@ -254,28 +1313,186 @@ uint16_t get_debug_port_from_config() {
         return base_port + port_offset;
     }
     return 0;
+#endif // WILTON_DUKTAPE_NO_DEBUGGER
+}
+
+class thread_engine {
+public:
+    duk_context* ctx = nullptr;
+    const duktape_heap_counters* heap_counters = nullptr;
+    // accessed only from the engine thread
+    std::unordered_map<std::string, sl::json::value> heap_snapshots;
+};
+
+uint64_t saturating_sub(uint64_t value, uint64_t sub) {
+    return value > sub ? value - sub : 0;
+}
+
+// snapshots thread CPU time, wall time, allocations and native calls time
+// when started, records the differences when destroyed, costs of nested
+// calls on the same engine are subtracted from the outer call
+class call_cost_scope {
+    duktape_cost_tracker* tracker;
+    const duktape_heap_counters& heap_counters;
+    const duktape_native_time& native_time;
+    call_cost_scope*& active;
+    call_cost_scope* outer = nullptr;
+    bool started = false;
+    uint64_t cpu_start = 0;
+    uint64_t wall_start = 0;
+    uint64_t allocated_start = 0;
+    uint64_t native_micros_start = 0;
+    uint64_t native_calls_start = 0;
+    // gross costs of the nested calls
+    duktape_call_cost nested;
+
+public:
+    std::string module;
+    std::string func;
+    bool failed = true;
+
+    call_cost_scope(duktape_cost_tracker* cost_tracker, const duktape_heap_counters& counters,
+            const duktape_native_time& native, call_cost_scope*& active_scope) :
+    tracker(cost_tracker),
+    heap_counters(counters),
+    native_time(native),
+    active(active_scope) { }
+
+    call_cost_scope(const call_cost_scope&) = delete;
+
+    call_cost_scope& operator=(const call_cost_scope&) = delete;
+
+    ~call_cost_scope() STATICLIB_NOEXCEPT {
+        if (!started) {
+            return;
+        }
+        active = outer;
+        auto gross = duktape_call_cost();
+        gross.cpu_micros = current_thread_cpu_time_micros() - cpu_start;
+        gross.wall_micros = current_time_micros() - wall_start;
+        gross.allocated_bytes = heap_counters.allocated_bytes.load(std::memory_order_relaxed) - allocated_start;
+        gross.native_micros = native_time.micros - native_micros_start;
+        gross.native_calls = native_time.calls - native_calls_start;
+        if (nullptr != outer) {
+            outer->nested.cpu_micros += gross.cpu_micros;
+            outer->nested.wall_micros += gross.wall_micros;
+            outer->nested.allocated_bytes += gross.allocated_bytes;
+            outer->nested.native_micros += gross.native_micros;
+            outer->nested.native_calls += gross.native_calls;
+        }
+        auto cost = duktape_call_cost();
+        cost.cpu_micros = saturating_sub(gross.cpu_micros, nested.cpu_micros);
+        cost.wall_micros = saturating_sub(gross.wall_micros, nested.wall_micros);
+        cost.allocated_bytes = saturating_sub(gross.allocated_bytes, nested.allocated_bytes);
+        // nested call runs inside the outer native call, that entered it
+        cost.native_micros = saturating_sub(gross.native_micros, nested.native_micros + nested.wall_micros);
+        cost.native_calls = saturating_sub(gross.native_calls, nested.native_calls);
+        cost.failed = failed;
+        try {
+            tracker->record(module, func, cost);
+        } catch (const std::exception& e) {
+            wilton::support::log_error("wilton.engine.duktape.costs",
+                    TRACEMSG(e.what() + "\nError recording call cost"));
+        }
+    }
+
+    bool is_enabled() const {
+        return nullptr != tracker;
+    }
+
+    void start() {
+        if (nullptr == tracker) {
+            return;
+        }
+        started = true;
+        outer = active;
+        active = this;
+        cpu_start = current_thread_cpu_time_micros();
+        wall_start = current_time_micros();
+        allocated_start = heap_counters.allocated_bytes.load(std::memory_order_relaxed);
+        native_micros_start = native_time.micros;
+        native_calls_start = native_time.calls;
+    }
+};
+
+// engines by the threads they are running on, used by heap census
+std::mutex thread_engines_mutex;
+std::unordered_map<std::thread::id, thread_engine*> thread_engines;
+
+thread_engine* find_current_thread_engine() {
+    std::lock_guard<std::mutex> guard{thread_engines_mutex};
+    auto it = thread_engines.find(std::this_thread::get_id());
+    return thread_engines.end() != it ? it->second : nullptr;
 }
 
 } // namespace
 
 class duktape_engine::impl : public sl::pimpl::object::impl {
+    // must be initialized before the heap is created
+    std::shared_ptr<duktape_engine_placement> placement;
+    // must outlive the heap, finalizers may clear timers
+    std::shared_ptr<duktape_event_loop> event_loop;
+    std::shared_ptr<duktape_watched_engine> watched;
+    size_t watched_summary_len;
     std::unique_ptr<duk_context, std::function<void(duk_context*)>> dukctx;
     duktape_debug_transport debug_transport;
+    size_t native_functions_bound = 0;
+    bool reset_globals_after_call;
+    thread_engine census_entry;
+    std::shared_ptr<duktape_cost_tracker> cost_tracker;
+    duktape_native_time native_time;
+    call_cost_scope* active_cost_scope = nullptr;
 
 public:
     impl(sl::io::span<const char> init_code) :
-    dukctx(duk_create_heap(nullptr, nullptr, nullptr, nullptr, fatal_handler), ctx_deleter),
-    debug_transport(get_debug_port_from_config()) {
+    placement(shared_placement()->place_current_thread()),
+    event_loop(std::make_shared<duktape_event_loop>()),
+    watched(shared_watchdog()->register_engine()),
+    watched_summary_len(shared_watchdog()->summary_length()),
+    dukctx(duk_create_heap(duktape_alloc, duktape_realloc, duktape_free,
+            static_cast<void*> (std::addressof(placement->heap_counters)), fatal_handler),
+            make_ctx_deleter(placement, event_loop, watched)),
+    debug_transport(get_debug_port_from_config()),
+    reset_globals_after_call(load_duktape_config()["resetGlobals"].as_bool(false)),
+    cost_tracker(shared_cost_tracker()) {
         wilton::support::log_info("wilton.engine.duktape.init", "Initializing engine instance ...");
+        // watched engine outlives the heap, it is kept by the heap deleter
+        placement->heap_counters.abort_requested = std::addressof(watched->abort_requested);
         auto ctx = dukctx.get();
         if (nullptr == ctx) throw support::exception(TRACEMSG(
                 "Error creating Duktape context"));
         auto def = sl::support::defer([ctx]() STATICLIB_NOEXCEPT {
             pop_stack(ctx);
         });
+        init_stash(ctx);
+        wrap_finalizer_setter(ctx);
         register_c_func(ctx, "WILTON_load", load_func, 1);
         register_c_func(ctx, "WILTON_wiltoncall", wiltoncall_func, 2);
+        register_c_func(ctx, "WILTON_wiltoncall_start", wiltoncall_start_func, 2);
+        register_c_func(ctx, "WILTON_wiltoncall_wait", wiltoncall_wait_func, 2);
+        register_c_func(ctx, "WILTON_wiltoncall_async", wiltoncall_async_func, 3);
+        register_c_func(ctx, "WILTON_run_event_loop", run_event_loop_func, 1);
+        register_c_func(ctx, "WILTON_parallel_map", parallel_map_func, 4);
+        register_c_func(ctx, "setTimeout", set_timeout_func, 2);
+        register_c_func(ctx, "setInterval", set_interval_func, 2);
+        register_c_func(ctx, "clearTimeout", clear_timer_func, 1);
+        register_c_func(ctx, "clearInterval", clear_timer_func, 1);
+        register_c_func(ctx, "WILTON_stream_write", stream_write_func, 2);
+        register_c_func(ctx, "WILTON_stream_read", stream_read_func, 2);
+        register_c_func(ctx, "WILTON_channel_create", channel_create_func, 2);
+        register_c_func(ctx, "WILTON_channel_close", channel_close_func, 1);
+        register_c_func(ctx, "WILTON_channel_send", channel_send_func, 3);
+        register_c_func(ctx, "WILTON_channel_receive", channel_receive_func, 2);
+        register_c_func(ctx, "WILTON_cache_get", cache_get_func, 1);
+        register_c_func(ctx, "WILTON_cache_put", cache_put_func, 3);
+        register_c_func(ctx, "WILTON_cache_remove", cache_remove_func, 1);
+        register_native_primitives(ctx);
+        register_cbor_functions(ctx);
         eval_js(ctx, init_code.data(), init_code.size());
+        if (reset_globals_after_call) {
+            record_globals_baseline(ctx);
+        }
+        bind_native_functions(ctx);
         wilton::support::log_info("wilton.engine.duktape.init", "Engine initialization complete");
 
         // if debug port specified - run debugging
@@ -296,9 +1513,21 @@ public:
                     static_cast<void*> (std::addressof(debug_transport))); // udata
         }
 
+        census_entry.ctx = ctx;
+        census_entry.heap_counters = std::addressof(placement->heap_counters);
+        std::lock_guard<std::mutex> guard{thread_engines_mutex};
+        thread_engines[std::this_thread::get_id()] = std::addressof(census_entry);
     }
 
     ~impl() STATICLIB_NOEXCEPT {
+        shared_async_calls()->discard(this);
+        {
+            std::lock_guard<std::mutex> guard{thread_engines_mutex};
+            auto it = thread_engines.find(std::this_thread::get_id());
+            if (thread_engines.end() != it && std::addressof(census_entry) == it->second) {
+                thread_engines.erase(it);
+            }
+        }
         // try to detach context from debugger
         if (debug_transport.is_active()) {
             auto ctx = dukctx.get();
@@ -311,37 +1540,198 @@ public:
         auto def = sl::support::defer([ctx]() STATICLIB_NOEXCEPT {
             pop_stack(ctx);
         });
+        // runs before the stack is cleaned, result is already copied by then
+        auto reset = sl::support::defer([this, ctx]() STATICLIB_NOEXCEPT {
+            if (reset_globals_after_call) {
+                duk_safe_call(ctx, reset_globals, 0, 1);
+                duk_pop(ctx);
+            }
+        });
+        watched->begin_call(callback_script_json, watched_summary_len);
+        auto watched_end = sl::support::defer([this]() STATICLIB_NOEXCEPT {
+            watched->end_call();
+        });
+        bind_native_functions(ctx);
+        placement->check_current_node();
+        // engine cannot be entered between calls, timers and completions,
+        // that became due while it was idle, run before the handler
+        if (event_loop->has_pending()) {
+            run_event_loop(ctx, 0);
+        }
+        duktape_trace_span span("js", "run_callback_script", std::strlen("run_callback_script"),
+                callback_script_json.size());
+
+        // callers negotiate CBOR per call with self-describe tag prefix
+        auto cbor = is_cbor_payload(callback_script_json);
+        auto invoke = is_invoke_payload(callback_script_json);
+        call_cost_scope cost(cost_tracker->is_enabled() ? cost_tracker.get() : nullptr,
+                placement->heap_counters, native_time, active_cost_scope);
+        if (cost.is_enabled() && !invoke) {
+            // script was parsed by runscript_duktape
+            auto info = current_callback_info();
+            if (nullptr != info) {
+                cost.module = info->module;
+                cost.func = info->func;
+            }
+        }
+        cost.start();
+        duk_idx_t nargs = 1;
+        if (invoke) {
+            auto args = sl::io::span<const char>(nullptr, 0);
+            auto handle = parse_invoke_payload(callback_script_json, args);
+            wilton::support::log_debug("wilton.engine.duktape.run",
+                    "Invoking prepared handler, handle: [" + sl::support::to_string(handle) + "]," +
+                    " args length: [" + sl::support::to_string(args.size()) + "] ...");
+            cbor = is_cbor_payload(args);
+            duk_push_global_stash(ctx);
+            duk_get_prop_string(ctx, -1, handler_invoke_key);
+            duk_insert(ctx, -2);
+            push_prepared_handler(ctx, handle);
+            duk_remove(ctx, -3);
+            if (cost.is_enabled()) {
+                auto handler = shared_prepared_handlers()->find(handle);
+                cost.module = handler->module;
+                cost.func = handler->func;
+            }
+            if (cbor) {
+                cbor_decode(ctx, args);
+            } else {
+                duk_push_lstring(ctx, args.data(), args.size());
+            }
+            nargs = 3;
+        } else if (cbor) {
+            wilton::support::log_debug("wilton.engine.duktape.run",
+                    "Running CBOR callback script, length: [" + sl::support::to_string(callback_script_json.size()) + "] ...");
+            duk_push_global_stash(ctx);
+            duk_get_prop_string(ctx, -1, callback_dispatch_key);
+            cbor_decode(ctx, callback_script_json);
+        } else {
+            wilton::support::log_debug("wilton.engine.duktape.run", 
+                    "Running callback script: [" + std::string(callback_script_json.data(), callback_script_json.size()) + "] ...");
+            duk_get_global_string(ctx, "WILTON_run");
 
-        wilton::support::log_debug("wilton.engine.duktape.run", 
-                "Running callback script: [" + std::string(callback_script_json.data(), callback_script_json.size()) + "] ...");
-        duk_get_global_string(ctx, "WILTON_run");
-        
-        duk_push_lstring(ctx, callback_script_json.data(), callback_script_json.size());
-        auto err = duk_pcall(ctx, 1);
+            duk_push_lstring(ctx, callback_script_json.data(), callback_script_json.size());
+        }
+        auto err = duk_pcall(ctx, nargs);
 
         wilton::support::log_debug("wilton.engine.duktape.run",
                 "Callback run complete, result: [" + sl::support::to_string_bool(DUK_EXEC_SUCCESS == err) + "]");
         if (DUK_EXEC_SUCCESS != err) {
             throw support::exception(TRACEMSG(format_stacktrace(ctx)));
         }
-        if (DUK_TYPE_STRING == duk_get_type(ctx, -1)) {
+        cost.failed = false;
+        auto res = support::make_null_buffer();
+        if (cbor) {
+            if (!duk_is_null_or_undefined(ctx, -1)) {
+                auto out = std::string();
+                duk_push_pointer(ctx, static_cast<void*> (std::addressof(out)));
+                if (DUK_EXEC_SUCCESS != duk_safe_call(ctx, encode_cbor_result_func, 2, 1)) {
+                    throw support::exception(TRACEMSG(format_stacktrace(ctx) +
+                            "\nCBOR result encode error"));
+                }
+                span.set_output_len(out.length());
+                res = support::make_array_buffer(out.data(), static_cast<int> (out.length()));
+            }
+        } else if (DUK_TYPE_STRING == duk_get_type(ctx, -1)) {
             size_t len;
-            const char* str = duk_get_lstring(ctx, -1, std::addressof(len));            
-            return support::make_array_buffer(str, static_cast<int> (len));            
+            const char* str = duk_get_lstring(ctx, -1, std::addressof(len));
+            span.set_output_len(len);
+            res = support::make_array_buffer(str, static_cast<int> (len));
+        }
+        // timers and completions, that became due during the call
+        if (event_loop->has_pending()) {
+            run_event_loop(ctx, 0);
         }
-        return support::make_null_buffer();
+        return res;
     } 
 
     void run_garbage_collector(duktape_engine&) {
         auto ctx = dukctx.get();
+        // Duktape 1.x has no hook for automatic mark-and-sweep, only explicit runs are traced
+        duktape_trace_span span("gc", "explicit_gc", std::strlen("explicit_gc"), 0);
         duk_gc(ctx, 0);
         // You may want to call this function twice to ensure even
         // objects with finalizers are collected.
         // http://duktape.org/api.html#duk_gc
         duk_gc(ctx, 0);
     }
+
+private:
+    void init_stash(duk_context* ctx) {
+        duk_push_global_stash(ctx);
+        duk_push_pointer(ctx, static_cast<void*> (watched.get()));
+        duk_put_prop_string(ctx, -2, watchdog_key);
+        duk_push_pointer(ctx, static_cast<void*> (std::addressof(event_loop)));
+        duk_put_prop_string(ctx, -2, event_loop_key);
+        duk_push_pointer(ctx, static_cast<void*> (this));
+        duk_put_prop_string(ctx, -2, engine_key);
+        duk_push_error_object(ctx, DUK_ERR_ERROR, "%s", "Call aborted by watchdog");
+        duk_put_prop_string(ctx, -2, abort_error_key);
+        duk_push_error_object(ctx, DUK_ERR_TYPE_ERROR, "%s", "Invalid arguments specified");
+        duk_put_prop_string(ctx, -2, invalid_args_error_key);
+        if (cost_tracker->is_enabled()) {
+            duk_push_pointer(ctx, static_cast<void*> (std::addressof(native_time)));
+            duk_put_prop_string(ctx, -2, native_time_key);
+        }
+        duk_push_object(ctx);
+        duk_put_prop_string(ctx, -2, event_callbacks_key);
+        eval_js(ctx, callback_dispatch_code.c_str(), callback_dispatch_code.length());
+        duk_put_prop_string(ctx, -2, callback_dispatch_key);
+        eval_js(ctx, handler_resolve_code.c_str(), handler_resolve_code.length());
+        duk_put_prop_string(ctx, -2, handler_resolve_key);
+        eval_js(ctx, handler_invoke_code.c_str(), handler_invoke_code.length());
+        duk_put_prop_string(ctx, -2, handler_invoke_key);
+        duk_push_object(ctx);
+        duk_put_prop_string(ctx, -2, prepared_handlers_key);
+        duk_pop(ctx);
+        init_heap_census(ctx);
+    }
+
+    void bind_native_functions(duk_context* ctx) {
+        auto registry = shared_function_registry();
+        if (registry->count() == native_functions_bound) {
+            return;
+        }
+        auto list = registry->list_since(native_functions_bound);
+        for (auto& fun : list) {
+            bind_native_function(ctx, fun.get());
+        }
+        native_functions_bound += list.size();
+        // new bindings must survive the reset
+        if (reset_globals_after_call) {
+            record_globals_baseline(ctx);
+        }
+    }
 };
 
+sl::json::value run_heap_census(const sl::json::value& options) {
+    auto en = find_current_thread_engine();
+    if (nullptr == en) throw support::exception(TRACEMSG(
+            "Duktape engine is not running on current thread"));
+    auto census = heap_census(en->ctx, options["top"].as_uint32(20),
+            static_cast<uint64_t> (options["maxObjects"].as_int64(1 << 20)));
+    auto& fields = census.as_object_or_throw(TRACEMSG("Invalid heap census"));
+    fields.emplace_back("heapAllocatedBytes",
+            static_cast<int64_t> (en->heap_counters->allocated_bytes.load(std::memory_order_relaxed)));
+    fields.emplace_back("heapLiveBytes", en->heap_counters->live_bytes.load(std::memory_order_relaxed));
+    auto& diff_with = options["diffWith"].as_string();
+    auto diff = sl::json::value();
+    if (!diff_with.empty()) {
+        auto it = en->heap_snapshots.find(diff_with);
+        if (en->heap_snapshots.end() == it) throw support::exception(TRACEMSG(
+                "Heap snapshot not found, name: [" + diff_with + "]"));
+        diff = heap_census_diff(it->second, census);
+    }
+    auto& snapshot = options["snapshot"].as_string();
+    if (!snapshot.empty()) {
+        en->heap_snapshots[snapshot] = census.clone();
+    }
+    if (!diff_with.empty()) {
+        fields.emplace_back("diff", std::move(diff));
+    }
+    return census;
+}
+
 PIMPL_FORWARD_CONSTRUCTOR(duktape_engine, (sl::io::span<const char>), (), support::exception)
 PIMPL_FORWARD_METHOD(duktape_engine, support::buffer, run_callback_script, (sl::io::span<const char>), (), support::exception)
 PIMPL_FORWARD_METHOD(duktape_engine, void, run_garbage_collector, (), (), support::exception)
@@ -57,6 +57,17 @@ public:
     void run_garbage_collector();
 };
 
+/**
+ * Walks the heap of the engine running on the current thread,
+ * must be called from a native call made by that engine.
+ * Census can be stored under the "snapshot" name and compared
+ * with a previously stored one specified as "diffWith".
+ * 
+ * @param options census options
+ * @return census JSON
+ */
+sl::json::value run_heap_census(const sl::json::value& options);
+
 } // namespace
 }
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_event_loop.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 6:20 PM
+ */
+
+#include "duktape_event_loop.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+uint64_t current_time_millis() {
+    auto now = std::chrono::steady_clock::now();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count());
+}
+
+class timer_entry {
+public:
+    uint64_t due;
+    // keeps timers with equal due time in FIFO order
+    uint64_t seq;
+    uint64_t id;
+
+    timer_entry(uint64_t due, uint64_t seq, uint64_t id) :
+    due(due),
+    seq(seq),
+    id(id) { }
+
+    bool operator>(const timer_entry& other) const {
+        return due > other.due || (due == other.due && seq > other.seq);
+    }
+};
+
+} // namespace
+
+class duktape_event_loop::impl : public sl::pimpl::object::impl {
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    uint64_t last_id = 0;
+    uint64_t last_seq = 0;
+    // cancelled timers are removed from the heap lazily
+    std::priority_queue<timer_entry, std::vector<timer_entry>, std::greater<timer_entry>> timers_heap;
+    // active timers, id -> interval, zero for one-shot timers
+    std::unordered_map<uint64_t, uint64_t> timers;
+    uint64_t pending_calls = 0;
+    std::deque<duktape_loop_event> completed;
+
+public:
+    impl() { }
+
+    uint64_t add_timer(duktape_event_loop&, uint64_t delay_millis, bool repeat) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto id = ++last_id;
+        // zero interval would spin the loop
+        auto interval = repeat ? std::max(delay_millis, static_cast<uint64_t> (1)) : 0;
+        timers.insert(std::make_pair(id, interval));
+        timers_heap.emplace(current_time_millis() + delay_millis, ++last_seq, id);
+        return id;
+    }
+
+    bool cancel_timer(duktape_event_loop&, uint64_t id) {
+        std::lock_guard<std::mutex> guard{mutex};
+        return timers.erase(id) > 0;
+    }
+
+    uint64_t add_pending_call(duktape_event_loop&) {
+        std::lock_guard<std::mutex> guard{mutex};
+        pending_calls += 1;
+        return ++last_id;
+    }
+
+    void complete_call(duktape_event_loop&, uint64_t id, bool failed, bool has_data, std::string data) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto ev = duktape_loop_event();
+        ev.id = id;
+        ev.failed = failed;
+        ev.has_data = has_data;
+        ev.data = std::move(data);
+        completed.emplace_back(std::move(ev));
+        cv.notify_all();
+    }
+
+    bool next_event(duktape_event_loop&, int64_t timeout_millis, duktape_loop_event& event_out) {
+        auto deadline = current_time_millis() + static_cast<uint64_t> (std::max(timeout_millis, static_cast<int64_t> (0)));
+        std::unique_lock<std::mutex> guard{mutex};
+        for (;;) {
+            if (!completed.empty()) {
+                event_out = std::move(completed.front());
+                completed.pop_front();
+                pending_calls -= 1;
+                return true;
+            }
+            while (!timers_heap.empty() && 0 == timers.count(timers_heap.top().id)) {
+                timers_heap.pop();
+            }
+            auto now = current_time_millis();
+            if (!timers_heap.empty() && timers_heap.top().due <= now) {
+                auto top = timers_heap.top();
+                timers_heap.pop();
+                auto it = timers.find(top.id);
+                auto repeat = 0 != it->second;
+                if (repeat) {
+                    timers_heap.emplace(now + it->second, ++last_seq, top.id);
+                } else {
+                    timers.erase(it);
+                }
+                event_out = duktape_loop_event();
+                event_out.id = top.id;
+                event_out.timer = true;
+                event_out.repeat = repeat;
+                return true;
+            }
+            if (timers_heap.empty() && 0 == pending_calls) {
+                return false;
+            }
+            if (timeout_millis >= 0 && now >= deadline) {
+                return false;
+            }
+            if (timers_heap.empty()) {
+                cv.wait(guard);
+            } else {
+                auto wake = timers_heap.top().due;
+                if (timeout_millis >= 0) {
+                    wake = std::min(wake, deadline);
+                }
+                cv.wait_for(guard, std::chrono::milliseconds(wake - now));
+            }
+        }
+    }
+
+    bool has_pending(const duktape_event_loop&) const {
+        std::lock_guard<std::mutex> guard{mutex};
+        return !timers.empty() || pending_calls > 0;
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_event_loop, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_event_loop, uint64_t, add_timer, (uint64_t)(bool), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_event_loop, bool, cancel_timer, (uint64_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_event_loop, uint64_t, add_pending_call, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_event_loop, void, complete_call, (uint64_t)(bool)(bool)(std::string), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_event_loop, bool, next_event, (int64_t)(duktape_loop_event&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_event_loop, bool, has_pending, (), (const), support::exception)
+
+} // namespace
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_event_loop.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 6:20 PM
+ */
+
+#ifndef WILTON_DUKTAPE_EVENT_LOOP_HPP
+#define WILTON_DUKTAPE_EVENT_LOOP_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Timer expiration or asynchronous call completion
+ */
+class duktape_loop_event {
+public:
+    uint64_t id = 0;
+    bool timer = false;
+    bool repeat = false;
+    bool failed = false;
+    bool has_data = false;
+    std::string data;
+};
+
+/**
+ * Per-engine event queue, timers are kept in a binary heap,
+ * call completions can be posted from any thread.
+ *
+ * Events are run only on the engine owner thread: on entry to and on exit
+ * from a callback script call and inside WILTON_run_event_loop. Engine
+ * that is idle between calls does not fire its timers until the next call.
+ */
+class duktape_event_loop : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_event_loop)
+
+    duktape_event_loop();
+
+    uint64_t add_timer(uint64_t delay_millis, bool repeat);
+
+    bool cancel_timer(uint64_t id);
+
+    uint64_t add_pending_call();
+
+    void complete_call(uint64_t id, bool failed, bool has_data, std::string data);
+
+    /**
+     * Zero timeout returns only events that are already due, negative
+     * timeout waits until the event is available
+     *
+     * @return false if no events are due before timeout or
+     *         there are no timers and pending calls left
+     */
+    bool next_event(int64_t timeout_millis, duktape_loop_event& event_out);
+
+    bool has_pending() const;
+};
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_EVENT_LOOP_HPP */
+
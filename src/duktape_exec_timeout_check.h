@@ -0,0 +1,34 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_exec_timeout_check.h
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_EXEC_TIMEOUT_CHECK_H
+#define WILTON_DUKTAPE_EXEC_TIMEOUT_CHECK_H
+
+/*
+ * Force-included into "duktape.c" of the performance build, where
+ * "DUK_OPT_EXEC_TIMEOUT_CHECK" is set to this function, implemented
+ * in "duktape_allocator.cpp", both are compiled as C++
+ */
+int wilton_duktape_exec_timeout_check(void* udata);
+
+#endif /* WILTON_DUKTAPE_EXEC_TIMEOUT_CHECK_H */
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_function_registry.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 12:30 PM
+ */
+
+#include "duktape_function_registry.hpp"
+
+#include <atomic>
+#include <mutex>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/logging.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+bool is_valid_name(const std::string& name) {
+    if (name.empty() || '.' == name.front() || '.' == name.back()) {
+        return false;
+    }
+    return std::string::npos == name.find("..");
+}
+
+} // namespace
+
+class duktape_function_registry::impl : public sl::pimpl::object::impl {
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<duktape_native_function>> functions;
+    // checked by engines before each call without locking
+    std::atomic<size_t> functions_count;
+
+public:
+    impl() {
+        functions_count.store(0, std::memory_order_release);
+    }
+
+    void register_function(duktape_function_registry&, const std::string& name, void* fun_ctx,
+            native_function_callback fun_cb) {
+        if (!is_valid_name(name)) throw support::exception(TRACEMSG(
+                "Invalid native function name specified: [" + name + "]"));
+        if (nullptr == fun_cb) throw support::exception(TRACEMSG(
+                "Invalid null callback specified, function: [" + name + "]"));
+        std::lock_guard<std::mutex> guard{mutex};
+        for (auto& fun : functions) {
+            if (name == fun->name) throw support::exception(TRACEMSG(
+                    "Native function is already registered, name: [" + name + "]"));
+        }
+        functions.emplace_back(std::make_shared<duktape_native_function>(name, fun_ctx, fun_cb));
+        functions_count.store(functions.size(), std::memory_order_release);
+        wilton::support::log_debug("wilton.engine.duktape.native",
+                "Native function registered, name: [" + name + "]");
+    }
+
+    size_t count(const duktape_function_registry&) const {
+        return functions_count.load(std::memory_order_acquire);
+    }
+
+    std::vector<std::shared_ptr<duktape_native_function>> list_since(const duktape_function_registry&,
+            size_t index) const {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = std::vector<std::shared_ptr<duktape_native_function>>();
+        for (size_t i = index; i < functions.size(); i++) {
+            res.push_back(functions[i]);
+        }
+        return res;
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_function_registry, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_function_registry, void, register_function, (const std::string&)(void*)(native_function_callback), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_function_registry, size_t, count, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_function_registry, std::vector<std::shared_ptr<duktape_native_function>>, list_since, (size_t), (const), support::exception)
+
+std::shared_ptr<duktape_function_registry> shared_function_registry() {
+    static auto registry = std::make_shared<duktape_function_registry>();
+    return registry;
+}
+
+} // namespace
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_function_registry.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 12:30 PM
+ */
+
+#ifndef WILTON_DUKTAPE_FUNCTION_REGISTRY_HPP
+#define WILTON_DUKTAPE_FUNCTION_REGISTRY_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/wilton_duktape.h"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+typedef char* (*native_function_callback)(void* fun_ctx, const wilton_DuktapeValue* args,
+        int args_count, wilton_DuktapeValue* result_out);
+
+/**
+ * Native function registered by other modules, entries
+ * are never removed, so engines can keep raw pointers to them
+ */
+class duktape_native_function {
+public:
+    std::string name;
+    void* ctx;
+    native_function_callback cb;
+
+    duktape_native_function(const std::string& fun_name, void* fun_ctx, native_function_callback fun_cb) :
+    name(fun_name),
+    ctx(fun_ctx),
+    cb(fun_cb) { }
+};
+
+class duktape_function_registry : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_function_registry)
+
+    duktape_function_registry();
+
+    void register_function(const std::string& name, void* fun_ctx, native_function_callback fun_cb);
+
+    size_t count() const;
+
+    std::vector<std::shared_ptr<duktape_native_function>> list_since(size_t index) const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_function_registry> shared_function_registry();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_FUNCTION_REGISTRY_HPP */
+
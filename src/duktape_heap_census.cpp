@@ -0,0 +1,434 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_heap_census.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:40 PM
+ */
+
+#include "duktape_heap_census.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "staticlib/support.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+// rough estimates of Duktape internal structures sizes
+const uint64_t object_base_bytes = 64;
+const uint64_t property_bytes = 24;
+const uint64_t string_base_bytes = 24;
+// walk is truncated when more objects are discovered, but not yet walked
+const size_t max_pending_objects = 1 << 16;
+const char* descriptor_func_key = "\xff" "wiltonCensusDescriptor";
+
+class census_object {
+public:
+    std::string name;
+    std::string key;
+    uint64_t properties;
+    uint64_t bytes;
+
+    census_object(std::string name, std::string key, uint64_t properties, uint64_t bytes) :
+    name(std::move(name)),
+    key(std::move(key)),
+    properties(properties),
+    bytes(bytes) { }
+
+    bool operator>(const census_object& other) const {
+        return bytes > other.bytes;
+    }
+};
+
+class census_state {
+public:
+    uint32_t top_count;
+    uint64_t max_objects;
+    bool truncated = false;
+    // builtin Object.getOwnPropertyDescriptor
+    duk_idx_t descriptor_idx = -1;
+
+    std::unordered_set<void*> visited;
+    // objects pending walk, with the key they were found under
+    std::vector<std::pair<void*, std::string>> pending;
+    std::unordered_map<void*, std::string> proto_names;
+    std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> by_constructor;
+    std::priority_queue<census_object, std::vector<census_object>, std::greater<census_object>> largest;
+
+    uint64_t objects = 0;
+    uint64_t object_bytes = 0;
+    uint64_t strings = 0;
+    uint64_t string_bytes = 0;
+    uint64_t buffers = 0;
+    uint64_t buffer_bytes = 0;
+
+    census_state(uint32_t top_count, uint64_t max_objects) :
+    top_count(top_count),
+    max_objects(max_objects) { }
+};
+
+// [key] -> [key descriptor], property values are read from descriptors,
+// so getters and Proxy traps are not invoked, undefined if not found
+void push_own_descriptor(duk_context* ctx, duk_idx_t obj_idx, census_state& st) {
+    duk_dup(ctx, st.descriptor_idx);
+    duk_dup(ctx, obj_idx);
+    duk_dup(ctx, -3);
+    if (DUK_EXEC_SUCCESS != duk_pcall(ctx, 2)) {
+        duk_pop(ctx);
+        duk_push_undefined(ctx);
+    }
+}
+
+// pushes value of own data property, undefined for accessors
+void push_own_data_value(duk_context* ctx, duk_idx_t obj_idx, const char* key, census_state& st) {
+    duk_push_string(ctx, key);
+    push_own_descriptor(ctx, obj_idx, st);
+    if (duk_is_object(ctx, -1)) {
+        duk_get_prop_string(ctx, -1, "value");
+    } else {
+        duk_push_undefined(ctx);
+    }
+    duk_remove(ctx, -2);
+    duk_remove(ctx, -2);
+}
+
+std::string constructor_name(duk_context* ctx, duk_idx_t idx, census_state& st) {
+    if (duk_is_array(ctx, idx)) {
+        return "Array";
+    }
+    if (duk_is_function(ctx, idx)) {
+        return "Function";
+    }
+    duk_get_prototype(ctx, idx);
+    void* proto = duk_get_heapptr(ctx, -1);
+    if (nullptr == proto) {
+        duk_pop(ctx);
+        // scope objects and other internal ones
+        return "(no prototype)";
+    }
+    auto it = st.proto_names.find(proto);
+    if (st.proto_names.end() != it) {
+        duk_pop(ctx);
+        return it->second;
+    }
+    auto name = std::string("Object");
+    auto proto_idx = duk_normalize_index(ctx, -1);
+    push_own_data_value(ctx, proto_idx, "constructor", st);
+    if (duk_is_function(ctx, -1)) {
+        push_own_data_value(ctx, duk_normalize_index(ctx, -1), "name", st);
+        size_t len = 0;
+        const char* str = duk_get_lstring(ctx, -1, std::addressof(len));
+        if (nullptr != str && len > 0) {
+            name = std::string(str, len);
+        }
+        duk_pop(ctx);
+    }
+    duk_pop_2(ctx);
+    st.proto_names.insert(std::make_pair(proto, name));
+    return name;
+}
+
+std::string key_string(duk_context* ctx, duk_idx_t idx) {
+    size_t len = 0;
+    const char* str = duk_get_lstring(ctx, idx, std::addressof(len));
+    if (nullptr == str) {
+        return std::string();
+    }
+    // internal keys are prefixed with 0xFF
+    if (len > 0 && '\xff' == str[0]) {
+        return std::string("_") + std::string(str + 1, len - 1);
+    }
+    return std::string(str, len);
+}
+
+void visit_value(duk_context* ctx, duk_idx_t idx, duk_idx_t keep_idx, duk_idx_t key_idx, census_state& st) {
+    auto type = duk_get_type(ctx, idx);
+    if (DUK_TYPE_STRING != type && DUK_TYPE_BUFFER != type && DUK_TYPE_OBJECT != type) {
+        return;
+    }
+    void* ptr = duk_get_heapptr(ctx, idx);
+    if (nullptr == ptr || !st.visited.insert(ptr).second) {
+        return;
+    }
+    duk_size_t len = 0;
+    switch (type) {
+    case DUK_TYPE_STRING:
+        duk_get_lstring(ctx, idx, std::addressof(len));
+        st.strings += 1;
+        st.string_bytes += string_base_bytes + len;
+        break;
+    case DUK_TYPE_BUFFER:
+        duk_get_buffer_data(ctx, idx, std::addressof(len));
+        st.buffers += 1;
+        st.buffer_bytes += len;
+        break;
+    default: {
+        if (st.pending.size() >= max_pending_objects) {
+            st.visited.erase(ptr);
+            st.truncated = true;
+            return;
+        }
+        // keep pending objects alive, finalizers, that run on GC triggered
+        // by census allocations, may drop other references to them,
+        // slots are reused, so array size is bounded by the pending count
+        duk_dup(ctx, idx);
+        duk_put_prop_index(ctx, keep_idx, static_cast<duk_uarridx_t> (st.pending.size()));
+        st.pending.emplace_back(ptr, key_idx >= 0 ? key_string(ctx, key_idx) : std::string());
+    }
+    }
+}
+
+// array part indices are enumerated as new strings, that are not in the heap otherwise
+bool is_array_index_key(duk_context* ctx, duk_idx_t obj_idx, duk_idx_t key_idx) {
+    if (!duk_is_array(ctx, obj_idx)) {
+        return false;
+    }
+    size_t len = 0;
+    const char* str = duk_get_lstring(ctx, key_idx, std::addressof(len));
+    if (nullptr == str || 0 == len || (len > 1 && '0' == str[0])) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+void walk_object(duk_context* ctx, duk_idx_t keep_idx, const std::string& key, census_state& st) {
+    auto obj_idx = duk_normalize_index(ctx, -1);
+    auto name = constructor_name(ctx, obj_idx, st);
+    uint64_t properties = 0;
+    // Proxy objects are walked as they are, without enumerate traps
+    duk_enum(ctx, obj_idx, DUK_ENUM_OWN_PROPERTIES_ONLY | DUK_ENUM_INCLUDE_NONENUMERABLE |
+            DUK_ENUM_INCLUDE_INTERNAL | DUK_ENUM_NO_PROXY_BEHAVIOR);
+    auto enum_idx = duk_normalize_index(ctx, -1);
+    while (duk_next(ctx, enum_idx, 0)) {
+        properties += 1;
+        auto key_idx = duk_normalize_index(ctx, -1);
+        if (!is_array_index_key(ctx, obj_idx, key_idx)) {
+            visit_value(ctx, key_idx, keep_idx, -1, st);
+        }
+        push_own_descriptor(ctx, obj_idx, st);
+        if (duk_is_object(ctx, -1)) {
+            // accessor functions are visited, but not called
+            duk_get_prop_string(ctx, -1, "value");
+            visit_value(ctx, -1, keep_idx, key_idx, st);
+            duk_pop(ctx);
+            duk_get_prop_string(ctx, -1, "get");
+            visit_value(ctx, -1, keep_idx, key_idx, st);
+            duk_pop(ctx);
+            duk_get_prop_string(ctx, -1, "set");
+            visit_value(ctx, -1, keep_idx, key_idx, st);
+            duk_pop(ctx);
+        }
+        duk_pop_2(ctx);
+    }
+    duk_pop(ctx);
+    duk_get_prototype(ctx, obj_idx);
+    visit_value(ctx, -1, keep_idx, -1, st);
+    duk_pop(ctx);
+    duk_size_t buf_len = 0;
+    duk_get_buffer_data(ctx, obj_idx, std::addressof(buf_len));
+
+    auto bytes = object_base_bytes + properties * property_bytes + buf_len;
+    auto& entry = st.by_constructor[name];
+    entry.first += 1;
+    entry.second += bytes;
+    st.objects += 1;
+    st.object_bytes += bytes;
+    if (st.top_count > 0 && (st.largest.size() < st.top_count || bytes > st.largest.top().bytes)) {
+        st.largest.emplace(name, key, properties, bytes);
+        if (st.largest.size() > st.top_count) {
+            st.largest.pop();
+        }
+    }
+}
+
+// [state_ptr] -> [undefined]
+duk_ret_t census_func(duk_context* ctx) {
+    auto st = static_cast<census_state*> (duk_get_pointer(ctx, 0));
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, descriptor_func_key);
+    duk_remove(ctx, -2);
+    if (!duk_is_function(ctx, -1)) {
+        duk_error(ctx, DUK_ERR_ERROR, "%s", "Heap census is not initialized");
+    }
+    st->descriptor_idx = duk_normalize_index(ctx, -1);
+    duk_push_array(ctx);
+    auto keep_idx = duk_normalize_index(ctx, -1);
+    duk_push_global_object(ctx);
+    visit_value(ctx, -1, keep_idx, -1, *st);
+    st->pending.back().second = "global";
+    duk_pop(ctx);
+    duk_push_global_stash(ctx);
+    visit_value(ctx, -1, keep_idx, -1, *st);
+    st->pending.back().second = "stash";
+    duk_pop(ctx);
+    while (!st->pending.empty()) {
+        if (st->objects >= st->max_objects) {
+            st->truncated = true;
+            break;
+        }
+        auto item = std::move(st->pending.back());
+        st->pending.pop_back();
+        duk_require_stack(ctx, 8);
+        duk_push_heapptr(ctx, item.first);
+        walk_object(ctx, keep_idx, item.second, *st);
+        duk_pop(ctx);
+    }
+    return 0;
+}
+
+int64_t to_int64(uint64_t val) {
+    return static_cast<int64_t> (val);
+}
+
+std::unordered_map<std::string, std::pair<int64_t, int64_t>> constructors_map(const sl::json::value& census) {
+    auto res = std::unordered_map<std::string, std::pair<int64_t, int64_t>>();
+    auto& arr = census["byConstructor"];
+    if (sl::json::type::array != arr.json_type()) {
+        return res;
+    }
+    for (auto& en : arr.as_array()) {
+        res[en["name"].as_string()] = std::make_pair(en["count"].as_int64(), en["approxBytes"].as_int64());
+    }
+    return res;
+}
+
+} // namespace
+
+void init_heap_census(duk_context* ctx) {
+    duk_push_global_stash(ctx);
+    duk_get_global_string(ctx, "Object");
+    duk_get_prop_string(ctx, -1, "getOwnPropertyDescriptor");
+    duk_remove(ctx, -2);
+    duk_put_prop_string(ctx, -2, descriptor_func_key);
+    duk_pop(ctx);
+}
+
+sl::json::value heap_census(duk_context* ctx, uint32_t top_count, uint64_t max_objects) {
+    auto st = census_state(top_count, max_objects);
+    duk_push_pointer(ctx, static_cast<void*> (std::addressof(st)));
+    auto err = duk_safe_call(ctx, census_func, 1, 1);
+    if (DUK_EXEC_SUCCESS != err) {
+        auto msg = std::string(duk_safe_to_string(ctx, -1));
+        duk_pop(ctx);
+        throw support::exception(TRACEMSG(msg + "\nHeap census error"));
+    }
+    duk_pop(ctx);
+
+    auto ctors = std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>>(
+            st.by_constructor.begin(), st.by_constructor.end());
+    std::sort(ctors.begin(), ctors.end(), [](const std::pair<std::string, std::pair<uint64_t, uint64_t>>& a,
+            const std::pair<std::string, std::pair<uint64_t, uint64_t>>& b) {
+        return a.second.second > b.second.second;
+    });
+    auto ctors_json = std::vector<sl::json::value>();
+    for (auto& en : ctors) {
+        ctors_json.emplace_back(sl::json::value({
+            { "name", en.first },
+            { "count", to_int64(en.second.first) },
+            { "approxBytes", to_int64(en.second.second) }
+        }));
+    }
+    auto largest = std::vector<census_object>();
+    while (!st.largest.empty()) {
+        largest.push_back(st.largest.top());
+        st.largest.pop();
+    }
+    auto largest_json = std::vector<sl::json::value>();
+    for (auto it = largest.rbegin(); it != largest.rend(); ++it) {
+        largest_json.emplace_back(sl::json::value({
+            { "name", it->name },
+            { "key", it->key },
+            { "properties", to_int64(it->properties) },
+            { "approxBytes", to_int64(it->bytes) }
+        }));
+    }
+    return sl::json::value({
+        { "objects", to_int64(st.objects) },
+        { "approxBytes", to_int64(st.object_bytes + st.string_bytes + st.buffer_bytes) },
+        { "truncated", st.truncated },
+        { "reachableStrings", sl::json::value({
+                { "count", to_int64(st.strings) },
+                { "approxBytes", to_int64(st.string_bytes) }
+            })
+        },
+        { "buffers", sl::json::value({
+                { "count", to_int64(st.buffers) },
+                { "bytes", to_int64(st.buffer_bytes) }
+            })
+        },
+        { "byConstructor", std::move(ctors_json) },
+        { "largest", std::move(largest_json) }
+    });
+}
+
+sl::json::value heap_census_diff(const sl::json::value& before, const sl::json::value& after) {
+    auto map_before = constructors_map(before);
+    auto map_after = constructors_map(after);
+    for (auto& en : map_before) {
+        // make sure that disappeared constructors are reported
+        map_after.insert(std::make_pair(en.first, std::make_pair(0, 0)));
+    }
+    auto deltas = std::vector<std::pair<std::string, std::pair<int64_t, int64_t>>>();
+    for (auto& en : map_after) {
+        auto it = map_before.find(en.first);
+        auto prev = map_before.end() != it ? it->second : std::make_pair<int64_t, int64_t>(0, 0);
+        auto count_delta = en.second.first - prev.first;
+        auto bytes_delta = en.second.second - prev.second;
+        if (0 != count_delta || 0 != bytes_delta) {
+            deltas.emplace_back(en.first, std::make_pair(count_delta, bytes_delta));
+        }
+    }
+    std::sort(deltas.begin(), deltas.end(), [](const std::pair<std::string, std::pair<int64_t, int64_t>>& a,
+            const std::pair<std::string, std::pair<int64_t, int64_t>>& b) {
+        return a.second.second > b.second.second;
+    });
+    auto deltas_json = std::vector<sl::json::value>();
+    for (auto& en : deltas) {
+        deltas_json.emplace_back(sl::json::value({
+            { "name", en.first },
+            { "countDelta", en.second.first },
+            { "approxBytesDelta", en.second.second }
+        }));
+    }
+    return sl::json::value({
+        { "objectsDelta", after["objects"].as_int64() - before["objects"].as_int64() },
+        { "approxBytesDelta", after["approxBytes"].as_int64() - before["approxBytes"].as_int64() },
+        { "byConstructor", std::move(deltas_json) }
+    });
+}
+
+} // namespace
+}
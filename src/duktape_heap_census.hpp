@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_heap_census.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_HEAP_CENSUS_HPP
+#define WILTON_DUKTAPE_HEAP_CENSUS_HPP
+
+#include <cstdint>
+
+#include "duktape.h"
+
+#include "staticlib/json.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Keeps builtin Object.getOwnPropertyDescriptor in the stash, must be
+ * called before any user code is run in the context
+ * 
+ * @param ctx Duktape context
+ */
+void init_heap_census(duk_context* ctx);
+
+/**
+ * Walks all values reachable from the global object and the global stash
+ * (including closure scopes) and groups objects by their constructor name.
+ * Property values are read from property descriptors, getters and Proxy
+ * traps are not invoked. Sizes are approximate, as Duktape doesn't expose its internal heap layout.
+ * Strings are counted only when reachable as property keys or values, strings
+ * held only by compiled functions and the rest of the string table are not
+ * included.
+ * 
+ * Can be called from a native function, value stack is left intact.
+ * 
+ * @param ctx Duktape context
+ * @param top_count number of largest objects to report
+ * @param max_objects walk is stopped after this number of objects
+ * @return census JSON
+ */
+sl::json::value heap_census(duk_context* ctx, uint32_t top_count, uint64_t max_objects);
+
+/**
+ * Compares two censuses returned by "heap_census"
+ * 
+ * @param before earlier census
+ * @param after later census
+ * @return differences JSON, constructors with largest growth go first
+ */
+sl::json::value heap_census_diff(const sl::json::value& before, const sl::json::value& after);
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_HEAP_CENSUS_HPP */
+
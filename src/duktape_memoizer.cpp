@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_memoizer.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 7:00 PM
+ */
+
+#include "duktape_memoizer.hpp"
+
+#include <atomic>
+#include <unordered_map>
+
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "duktape_config.hpp"
+#include "duktape_shared_cache.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const uint64_t default_max_bytes = 16 * 1024 * 1024;
+const uint32_t shards_count = 16;
+const char key_separator = '\x1f';
+const char json_key_marker = 'j';
+const char cbor_key_marker = 'c';
+
+std::string key_prefix(const std::string& module, const std::string& func) {
+    auto res = std::string();
+    res.append(module);
+    res.push_back(key_separator);
+    if (!func.empty()) {
+        res.append(func);
+        res.push_back(key_separator);
+    }
+    return res;
+}
+
+// args are parsed and re-serialized to ignore formatting differences,
+// only for calls of the memoized handlers
+bool append_json_args(sl::io::span<const char> args, std::string& key) {
+    key.push_back(json_key_marker);
+    if (0 == args.size()) {
+        key.append("null");
+        return true;
+    }
+    try {
+        key.append(sl::json::load(args).dumps());
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace
+
+class duktape_memoizer::impl : public sl::pimpl::object::impl {
+    // prefix -> TTL
+    std::unordered_map<std::string, uint64_t> handlers;
+    std::unique_ptr<duktape_shared_cache> results;
+    std::atomic<uint64_t> bypassed;
+    std::atomic<uint64_t> invalidated;
+
+public:
+    impl(const sl::json::value& config) {
+        for (auto& en : config["handlers"].as_array()) {
+            auto& module = en["module"].as_string_nonempty_or_throw("memoize.handlers.module");
+            auto& func = en["func"].as_string();
+            auto ttl = en["ttlMillis"].as_int64(0);
+            if (ttl < 0) throw support::exception(TRACEMSG(
+                    "Invalid 'memoize.handlers.ttlMillis' specified, must be non-negative," +
+                    " module: [" + module + "], value: [" + sl::support::to_string(ttl) + "]"));
+            handlers[key_prefix(module, func)] = static_cast<uint64_t> (ttl);
+        }
+        if (!handlers.empty()) {
+            auto max_bytes = config["maxBytes"].as_int64(static_cast<int64_t> (default_max_bytes));
+            if (max_bytes <= 0) throw support::exception(TRACEMSG(
+                    "Invalid 'memoize.maxBytes' specified, must be positive, value: [" +
+                    sl::support::to_string(max_bytes) + "]"));
+            results = sl::support::make_unique<duktape_shared_cache>(static_cast<uint64_t> (max_bytes), shards_count);
+        }
+        bypassed.store(0, std::memory_order_relaxed);
+        invalidated.store(0, std::memory_order_relaxed);
+    }
+
+    bool is_enabled(const duktape_memoizer&) const {
+        return !handlers.empty();
+    }
+
+    support::buffer run_script(duktape_memoizer&, const duktape_callback_info& info,
+            sl::io::span<const char> callback_script,
+            std::function<support::buffer(sl::io::span<const char>)> runner) {
+        if (handlers.empty()) {
+            return runner(callback_script);
+        }
+        auto key = std::string();
+        uint64_t ttl = 0;
+        if (info.valid) {
+            auto it = handlers.find(key_prefix(info.module, info.func));
+            if (handlers.end() == it) {
+                it = handlers.find(key_prefix(info.module, std::string()));
+            }
+            if (handlers.end() != it) {
+                ttl = it->second;
+                key = key_prefix(info.module, info.func);
+                // results of CBOR and JSON calls differ in format
+                if (info.cbor) {
+                    key.push_back(cbor_key_marker);
+                    key.append(info.args.data(), info.args.size());
+                } else if (!append_json_args(info.args, key)) {
+                    // invalid input is reported by the engine
+                    key.clear();
+                }
+            }
+        }
+        if (key.empty()) {
+            bypassed.fetch_add(1, std::memory_order_relaxed);
+            return runner(callback_script);
+        }
+        auto cached = results->get(key);
+        if (nullptr != cached.get()) {
+            return support::make_array_buffer(cached->data.data(), static_cast<int> (cached->data.length()));
+        }
+        auto res = runner(callback_script);
+        // null results are not cached
+        if (res.has_value()) {
+            auto& span = res.value();
+            auto value = std::make_shared<duktape_cache_value>(std::string(span.data(), span.size()), false);
+            results->put(key, std::move(value), ttl);
+        }
+        return res;
+    }
+
+    uint64_t invalidate(duktape_memoizer&, const std::string& module, const std::string& func) {
+        if (handlers.empty()) {
+            return 0;
+        }
+        uint64_t count = 0;
+        if (module.empty()) {
+            auto before = results->stats()["entries"].as_int64();
+            results->clear();
+            count = static_cast<uint64_t> (before);
+        } else {
+            count = results->remove_prefix(key_prefix(module, func));
+        }
+        invalidated.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    sl::json::value stats(const duktape_memoizer&) const {
+        if (handlers.empty()) {
+            return sl::json::value({
+                { "enabled", false }
+            });
+        }
+        auto st = results->stats();
+        auto hits = st["hits"].as_int64();
+        auto misses = st["misses"].as_int64();
+        auto total = hits + misses;
+        return sl::json::value({
+            { "enabled", true },
+            { "entries", st["entries"].as_int64() },
+            { "bytes", st["bytes"].as_int64() },
+            { "maxBytes", st["maxBytes"].as_int64() },
+            { "hits", hits },
+            { "misses", misses },
+            { "hitRate", total > 0 ? static_cast<double> (hits) / static_cast<double> (total) : 0.0 },
+            { "evictions", st["evictions"].as_int64() },
+            { "invalidated", static_cast<int64_t> (invalidated.load(std::memory_order_relaxed)) },
+            { "bypassed", static_cast<int64_t> (bypassed.load(std::memory_order_relaxed)) }
+        });
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_memoizer, (const sl::json::value&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_memoizer, bool, is_enabled, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_memoizer, support::buffer, run_script, (const duktape_callback_info&)(sl::io::span<const char>)(std::function<support::buffer(sl::io::span<const char>)>), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_memoizer, uint64_t, invalidate, (const std::string&)(const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_memoizer, sl::json::value, stats, (), (const), support::exception)
+
+std::shared_ptr<duktape_memoizer> shared_memoizer() {
+    static auto memoizer = [] {
+        auto cf = load_duktape_config();
+        return std::make_shared<duktape_memoizer>(cf["memoize"]);
+    } ();
+    return memoizer;
+}
+
+} // namespace
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_memoizer.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 7:00 PM
+ */
+
+#ifndef WILTON_DUKTAPE_MEMOIZER_HPP
+#define WILTON_DUKTAPE_MEMOIZER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/buffer.hpp"
+#include "wilton/support/exception.hpp"
+
+#include "duktape_callback_info.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Result cache for callback scripts of pure handlers listed in config,
+ * cached results are returned without entering an engine
+ */
+class duktape_memoizer : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_memoizer)
+
+    /**
+     * Config format: {"maxBytes": 16777216, "handlers": [{"module": "app/foo",
+     * "func": "bar", "ttlMillis": 1000}]}, empty "func" matches all
+     * module functions, zero TTL means no expiration
+     *
+     * @param config memoization config
+     */
+    duktape_memoizer(const sl::json::value& config);
+
+    bool is_enabled() const;
+
+    /**
+     * Returns cached result for the listed handlers, calls runner
+     * and caches its non-null result on miss
+     *
+     * @param info callback info read from the script
+     * @param callback_script JSON or CBOR callback script
+     * @param runner runs the script in an engine
+     * @return call result
+     */
+    support::buffer run_script(const duktape_callback_info& info, sl::io::span<const char> callback_script,
+            std::function<support::buffer(sl::io::span<const char>)> runner);
+
+    /**
+     * Empty module invalidates all results, empty func
+     * invalidates all results of the module
+     *
+     * @return number of invalidated results
+     */
+    uint64_t invalidate(const std::string& module, const std::string& func);
+
+    sl::json::value stats() const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_memoizer> shared_memoizer();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_MEMOIZER_HPP */
+
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_placement.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:00 PM
+ */
+
+#include "duktape_placement.hpp"
+
+#include <mutex>
+#include <thread>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/logging.hpp"
+
+#include "duktape_config.hpp"
+#include "duktape_platform.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const std::string logger = std::string("wilton.engine.duktape.placement");
+
+} // namespace
+
+duktape_engine_placement::duktape_engine_placement(const std::string& thread_id, int32_t cpu,
+        int32_t node, bool pinned, std::shared_ptr<const std::vector<int32_t>> cpu_nodes) :
+thread_id(thread_id),
+cpu(cpu),
+node(node),
+pinned(pinned),
+cpu_nodes(std::move(cpu_nodes)) {
+    calls.store(0, std::memory_order_relaxed);
+    cross_node_calls.store(0, std::memory_order_relaxed);
+}
+
+void duktape_engine_placement::check_current_node() {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    if (node < 0) {
+        return;
+    }
+    auto cur = current_cpu();
+    if (cur < 0 || static_cast<size_t> (cur) >= cpu_nodes->size()) {
+        return;
+    }
+    auto cur_node = (*cpu_nodes)[static_cast<size_t> (cur)];
+    if (cur_node >= 0 && cur_node != node) {
+        cross_node_calls.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+class duktape_placement::impl : public sl::pimpl::object::impl {
+    std::vector<uint32_t> cpus;
+    std::shared_ptr<const std::vector<int32_t>> cpu_nodes;
+    mutable std::mutex mutex;
+    size_t next_cpu_idx = 0;
+    mutable std::vector<std::weak_ptr<duktape_engine_placement>> engines;
+
+public:
+    impl(std::vector<uint32_t> cpus) :
+    cpus(std::move(cpus)) {
+        // topology is read once, lookups on calls must be cheap
+        auto nodes = std::make_shared<std::vector<int32_t>>();
+        uint32_t max_cpu = std::thread::hardware_concurrency();
+        for (auto cpu : this->cpus) {
+            if (cpu + 1 > max_cpu) {
+                max_cpu = cpu + 1;
+            }
+        }
+        for (uint32_t cpu = 0; cpu < max_cpu; cpu++) {
+            nodes->push_back(numa_node_of_cpu(cpu));
+        }
+        this->cpu_nodes = std::move(nodes);
+    }
+
+    std::shared_ptr<duktape_engine_placement> place_current_thread(duktape_placement&) {
+        auto tid = sl::support::to_string_any(std::this_thread::get_id());
+        int32_t cpu = -1;
+        int32_t node = -1;
+        bool pinned = false;
+        std::lock_guard<std::mutex> guard{mutex};
+        if (!cpus.empty()) {
+            auto idx = next_cpu_idx % cpus.size();
+            next_cpu_idx += 1;
+            pinned = pin_current_thread_to_cpu(cpus[idx]);
+            if (pinned) {
+                cpu = static_cast<int32_t> (cpus[idx]);
+                node = (*cpu_nodes)[cpus[idx]];
+                wilton::support::log_info(logger, "Engine thread, id: [" + tid + "]," +
+                        " pinned to CPU: [" + sl::support::to_string(cpu) + "]," +
+                        " NUMA node: [" + sl::support::to_string(node) + "]");
+            } else {
+                wilton::support::log_warn(logger, "Cannot pin engine thread, id: [" + tid + "]," +
+                        " to CPU: [" + sl::support::to_string(cpus[idx]) + "]");
+            }
+        }
+        if (!pinned) {
+            auto cur = current_cpu();
+            if (cur >= 0 && static_cast<size_t> (cur) < cpu_nodes->size()) {
+                node = (*cpu_nodes)[static_cast<size_t> (cur)];
+            }
+        }
+        auto res = std::make_shared<duktape_engine_placement>(tid, cpu, node, pinned, cpu_nodes);
+        prune_engines();
+        engines.emplace_back(res);
+        return res;
+    }
+
+    sl::json::value report(const duktape_placement&) const {
+        auto cpus_json = std::vector<sl::json::value>();
+        for (auto cpu : cpus) {
+            cpus_json.emplace_back(static_cast<int64_t> (cpu));
+        }
+        auto engines_json = std::vector<sl::json::value>();
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            prune_engines();
+            for (auto& weak : engines) {
+                auto en = weak.lock();
+                if (nullptr == en.get()) {
+                    continue;
+                }
+                engines_json.emplace_back(sl::json::value({
+                    { "threadId", en->thread_id },
+                    { "cpu", en->cpu },
+                    { "node", en->node },
+                    { "pinned", en->pinned },
+                    { "calls", static_cast<int64_t> (en->calls.load(std::memory_order_relaxed)) },
+                    { "crossNodeCalls", static_cast<int64_t> (en->cross_node_calls.load(std::memory_order_relaxed)) },
+                    { "heapAllocatedBytes", static_cast<int64_t> (en->heap_counters.allocated_bytes.load(std::memory_order_relaxed)) },
+                    { "heapLiveBytes", en->heap_counters.live_bytes.load(std::memory_order_relaxed) }
+                }));
+            }
+        }
+        return sl::json::value({
+            { "cpus", std::move(cpus_json) },
+            { "engines", std::move(engines_json) },
+            { "numaStats", numa_allocation_stats() }
+        });
+    }
+
+private:
+    void prune_engines() const {
+        auto it = engines.begin();
+        while (engines.end() != it) {
+            if (it->expired()) {
+                it = engines.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_placement, (std::vector<uint32_t>), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_placement, std::shared_ptr<duktape_engine_placement>, place_current_thread, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_placement, sl::json::value, report, (), (const), support::exception)
+
+std::shared_ptr<duktape_placement> shared_placement() {
+    static auto placement = [] {
+        auto cf = load_duktape_config();
+        auto cpus = std::vector<uint32_t>();
+        auto& cpus_json = cf["placement"]["cpus"];
+        if (sl::json::type::array == cpus_json.json_type()) {
+            for (auto& cpu : cpus_json.as_array()) {
+                cpus.push_back(cpu.as_uint32_or_throw("placement.cpus"));
+            }
+        }
+        return std::make_shared<duktape_placement>(std::move(cpus));
+    } ();
+    return placement;
+}
+
+} // namespace
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_placement.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:00 PM
+ */
+
+#ifndef WILTON_DUKTAPE_PLACEMENT_HPP
+#define WILTON_DUKTAPE_PLACEMENT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "duktape_allocator.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Placement of a single engine, engine thread is pinned
+ * to the CPU before the engine heap is created
+ */
+class duktape_engine_placement {
+public:
+    const std::string thread_id;
+    const int32_t cpu;
+    const int32_t node;
+    const bool pinned;
+    // NUMA nodes indexed by CPU, shared between engines
+    const std::shared_ptr<const std::vector<int32_t>> cpu_nodes;
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> cross_node_calls;
+    duktape_heap_counters heap_counters;
+
+    duktape_engine_placement(const std::string& thread_id, int32_t cpu, int32_t node, bool pinned,
+            std::shared_ptr<const std::vector<int32_t>> cpu_nodes);
+
+    duktape_engine_placement(const duktape_engine_placement&) = delete;
+
+    duktape_engine_placement& operator=(const duktape_engine_placement&) = delete;
+
+    /**
+     * Counts calls, that are running on other NUMA node than
+     * the engine heap, is a no-op when node is unknown
+     */
+    void check_current_node();
+};
+
+class duktape_placement : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_placement)
+
+    duktape_placement(std::vector<uint32_t> cpus);
+
+    /**
+     * Pins current thread to the next configured CPU (round-robin),
+     * does not pin when no CPUs are configured
+     */
+    std::shared_ptr<duktape_engine_placement> place_current_thread();
+
+    sl::json::value report() const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_placement> shared_placement();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_PLACEMENT_HPP */
+
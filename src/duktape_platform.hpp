@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_platform.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 3:30 PM
+ */
+
+#ifndef WILTON_DUKTAPE_PLATFORM_HPP
+#define WILTON_DUKTAPE_PLATFORM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "staticlib/json.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Pins current thread to the specified CPU
+ * 
+ * @param cpu CPU index
+ * @return false if pinning is not supported or failed
+ */
+bool pin_current_thread_to_cpu(uint32_t cpu);
+
+/**
+ * Returns CPU the current thread is running on
+ * 
+ * @return CPU index, -1 if not supported
+ */
+int32_t current_cpu();
+
+/**
+ * Returns NUMA node the specified CPU belongs to
+ * 
+ * @param cpu CPU index
+ * @return NUMA node index, -1 if not supported
+ */
+int32_t numa_node_of_cpu(uint32_t cpu);
+
+/**
+ * Returns per-node NUMA allocation counters, where
+ * they are exposed by the kernel
+ * 
+ * @return counters JSON, empty object if not supported
+ */
+sl::json::value numa_allocation_stats();
+
+/**
+ * Returns actual size of the block allocated with "malloc"
+ * 
+ * @param ptr allocated block
+ * @return block size, 0 if not supported
+ */
+size_t allocated_block_size(void* ptr);
+
+/**
+ * Maps the specified file into memory in read-only mode, on unix
+ * access to the mapped pages past the end of the file truncated
+ * after mapping raises SIGBUS, callers must check that file size
+ * is unchanged before using the mapped memory
+ * 
+ * @param path file path
+ * @param size_out mapped size
+ * @return mapped memory, nullptr if mapping failed or file is empty
+ */
+const char* map_file_readonly(const std::string& path, size_t& size_out);
+
+/**
+ * Unmaps memory mapped with "map_file_readonly"
+ * 
+ * @param data mapped memory
+ * @param size mapped size
+ */
+void unmap_file(const char* data, size_t size);
+
+/**
+ * Reads size and last modification time of the specified file
+ * 
+ * @param path file path
+ * @param size_out file size
+ * @param mtime_out modification time, in platform-specific units
+ * @return false if file cannot be accessed
+ */
+bool file_version(const std::string& path, uint64_t& size_out, int64_t& mtime_out);
+
+/**
+ * Returns CPU time consumed by the current thread
+ * 
+ * @return CPU time in microseconds, 0 if not supported
+ */
+uint64_t current_thread_cpu_time_micros();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_PLATFORM_HPP */
+
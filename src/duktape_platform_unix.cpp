@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_platform_unix.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 3:30 PM
+ */
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+#endif // __linux__
+
+#include "duktape_platform.hpp"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#endif // __APPLE__
+
+#include "staticlib/support.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+#ifdef __linux__
+const uint32_t max_numa_nodes = 64;
+#endif // __linux__
+
+} // namespace
+
+bool pin_current_thread_to_cpu(uint32_t cpu) {
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(std::addressof(set));
+    CPU_SET(cpu, std::addressof(set));
+    return 0 == pthread_setaffinity_np(pthread_self(), sizeof(set), std::addressof(set));
+#else // !__linux__
+    (void) cpu;
+    return false;
+#endif // __linux__
+}
+
+int32_t current_cpu() {
+#ifdef __linux__
+    return static_cast<int32_t> (sched_getcpu());
+#else // !__linux__
+    return -1;
+#endif // __linux__
+}
+
+int32_t numa_node_of_cpu(uint32_t cpu) {
+#ifdef __linux__
+    auto prefix = "/sys/devices/system/cpu/cpu" + sl::support::to_string(cpu) + "/node";
+    for (uint32_t node = 0; node < max_numa_nodes; node++) {
+        auto path = prefix + sl::support::to_string(node);
+        if (0 == access(path.c_str(), F_OK)) {
+            return static_cast<int32_t> (node);
+        }
+    }
+    return -1;
+#else // !__linux__
+    (void) cpu;
+    return -1;
+#endif // __linux__
+}
+
+sl::json::value numa_allocation_stats() {
+    auto nodes = std::vector<sl::json::field>();
+#ifdef __linux__
+    for (uint32_t node = 0; node < max_numa_nodes; node++) {
+        auto name = "node" + sl::support::to_string(node);
+        std::ifstream stream{"/sys/devices/system/node/" + name + "/numastat"};
+        if (!stream.is_open()) {
+            continue;
+        }
+        // lines like "numa_miss 12345"
+        auto counters = std::vector<sl::json::field>();
+        std::string key;
+        int64_t value = 0;
+        while (stream >> key >> value) {
+            counters.emplace_back(key, value);
+        }
+        nodes.emplace_back(name, std::move(counters));
+    }
+#endif // __linux__
+    return sl::json::value(std::move(nodes));
+}
+
+size_t allocated_block_size(void* ptr) {
+    if (nullptr == ptr) {
+        return 0;
+    }
+#if defined(__linux__)
+    return malloc_usable_size(ptr);
+#elif defined(__APPLE__)
+    return malloc_size(ptr);
+#else
+    return 0;
+#endif
+}
+
+const char* map_file_readonly(const std::string& path, size_t& size_out) {
+    size_out = 0;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (-1 == fd) {
+        return nullptr;
+    }
+    auto deferred = sl::support::defer([fd]() STATICLIB_NOEXCEPT {
+        // mapping stays valid after the descriptor is closed
+        close(fd);
+    });
+    struct stat st;
+    if (0 != fstat(fd, std::addressof(st)) || !S_ISREG(st.st_mode) || 0 == st.st_size) {
+        return nullptr;
+    }
+    auto size = static_cast<size_t> (st.st_size);
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == addr) {
+        return nullptr;
+    }
+    size_out = size;
+    return static_cast<const char*> (addr);
+}
+
+void unmap_file(const char* data, size_t size) {
+    if (nullptr != data) {
+        munmap(const_cast<char*> (data), size);
+    }
+}
+
+bool file_version(const std::string& path, uint64_t& size_out, int64_t& mtime_out) {
+    struct stat st;
+    if (0 != stat(path.c_str(), std::addressof(st))) {
+        return false;
+    }
+    size_out = static_cast<uint64_t> (st.st_size);
+#ifdef __APPLE__
+    auto& mt = st.st_mtimespec;
+#else // !__APPLE__
+    auto& mt = st.st_mtim;
+#endif // __APPLE__
+    mtime_out = static_cast<int64_t> (mt.tv_sec) * 1000000000 + static_cast<int64_t> (mt.tv_nsec);
+    return true;
+}
+
+uint64_t current_thread_cpu_time_micros() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+    if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, std::addressof(ts))) {
+        return 0;
+    }
+    return static_cast<uint64_t> (ts.tv_sec) * 1000000 + static_cast<uint64_t> (ts.tv_nsec) / 1000;
+#else // !CLOCK_THREAD_CPUTIME_ID
+    return 0;
+#endif // CLOCK_THREAD_CPUTIME_ID
+}
+
+} // namespace
+}
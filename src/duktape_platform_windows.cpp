@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_platform_windows.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 3:30 PM
+ */
+
+#include "duktape_platform.hpp"
+
+#include <malloc.h>
+
+#include <memory>
+#include <vector>
+
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+#include "staticlib/support/windows.hpp"
+
+namespace wilton {
+namespace duktape {
+
+bool pin_current_thread_to_cpu(uint32_t cpu) {
+    if (cpu >= sizeof(DWORD_PTR) * 8) {
+        return false;
+    }
+    DWORD_PTR mask = static_cast<DWORD_PTR> (1) << cpu;
+    return 0 != SetThreadAffinityMask(GetCurrentThread(), mask);
+}
+
+int32_t current_cpu() {
+    return static_cast<int32_t> (GetCurrentProcessorNumber());
+}
+
+int32_t numa_node_of_cpu(uint32_t cpu) {
+    if (cpu > 0xff) {
+        return -1;
+    }
+    UCHAR node = 0;
+    auto success = GetNumaProcessorNode(static_cast<UCHAR> (cpu), std::addressof(node));
+    if (0 == success || 0xff == node) {
+        return -1;
+    }
+    return static_cast<int32_t> (node);
+}
+
+sl::json::value numa_allocation_stats() {
+    // not exposed by the kernel
+    return sl::json::value(std::vector<sl::json::field>());
+}
+
+size_t allocated_block_size(void* ptr) {
+    if (nullptr == ptr) {
+        return 0;
+    }
+    return _msize(ptr);
+}
+
+const char* map_file_readonly(const std::string& path, size_t& size_out) {
+    size_out = 0;
+    auto wpath = sl::utils::widen(path);
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == file) {
+        return nullptr;
+    }
+    auto deferred_file = sl::support::defer([file]() STATICLIB_NOEXCEPT {
+        CloseHandle(file);
+    });
+    LARGE_INTEGER size;
+    if (0 == GetFileSizeEx(file, std::addressof(size)) || 0 == size.QuadPart) {
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (NULL == mapping) {
+        return nullptr;
+    }
+    auto deferred_mapping = sl::support::defer([mapping]() STATICLIB_NOEXCEPT {
+        // view keeps the mapping alive
+        CloseHandle(mapping);
+    });
+    void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (nullptr == addr) {
+        return nullptr;
+    }
+    size_out = static_cast<size_t> (size.QuadPart);
+    return static_cast<const char*> (addr);
+}
+
+void unmap_file(const char* data, size_t) {
+    if (nullptr != data) {
+        UnmapViewOfFile(data);
+    }
+}
+
+bool file_version(const std::string& path, uint64_t& size_out, int64_t& mtime_out) {
+    auto wpath = sl::utils::widen(path);
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (0 == GetFileAttributesExW(wpath.c_str(), GetFileExInfoStandard, std::addressof(data))) {
+        return false;
+    }
+    size_out = (static_cast<uint64_t> (data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    mtime_out = static_cast<int64_t> ((static_cast<uint64_t> (data.ftLastWriteTime.dwHighDateTime) << 32) |
+            data.ftLastWriteTime.dwLowDateTime);
+    return true;
+}
+
+uint64_t current_thread_cpu_time_micros() {
+    FILETIME creation;
+    FILETIME exit;
+    FILETIME kernel;
+    FILETIME user;
+    if (0 == GetThreadTimes(GetCurrentThread(), std::addressof(creation), std::addressof(exit),
+            std::addressof(kernel), std::addressof(user))) {
+        return 0;
+    }
+    // 100-nanosecond intervals
+    auto kernel_time = (static_cast<uint64_t> (kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    auto user_time = (static_cast<uint64_t> (user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return (kernel_time + user_time) / 10;
+}
+
+} // namespace
+}
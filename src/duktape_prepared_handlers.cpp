@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_prepared_handlers.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:00 PM
+ */
+
+
+#include "duktape_prepared_handlers.hpp"
+
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const char invoke_payload_marker = '\x01';
+const char invoke_payload_separator = ':';
+const char key_separator = '\x1f';
+// handles are passed through the C API as int
+const uint64_t max_handle = static_cast<uint64_t> (std::numeric_limits<int>::max());
+
+} // namespace
+
+class duktape_prepared_handlers::impl : public sl::pimpl::object::impl {
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<const duktape_prepared_handler>> handlers;
+    // module and func -> handle
+    std::unordered_map<std::string, uint64_t> handles;
+    uint64_t next_handle = 1;
+
+public:
+    impl() { }
+
+    uint64_t prepare(duktape_prepared_handlers&, const std::string& module, const std::string& func) {
+        if (module.empty()) throw support::exception(TRACEMSG(
+                "Invalid empty module name specified"));
+        if (func.empty()) throw support::exception(TRACEMSG(
+                "Invalid empty function name specified, module: [" + module + "]"));
+        auto key = module + key_separator + func;
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = handles.find(key);
+        if (handles.end() != it) {
+            return it->second;
+        }
+        if (next_handle > max_handle) throw support::exception(TRACEMSG(
+                "Prepared handlers limit exceeded, max handle: [" + sl::support::to_string(max_handle) + "]"));
+        auto handle = next_handle;
+        next_handle += 1;
+        handlers.insert(std::make_pair(handle, std::make_shared<duktape_prepared_handler>(handle, module, func)));
+        handles.insert(std::make_pair(std::move(key), handle));
+        return handle;
+    }
+
+    std::shared_ptr<const duktape_prepared_handler> find(const duktape_prepared_handlers&, uint64_t handle) const {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = handlers.find(handle);
+        if (handlers.end() == it) throw support::exception(TRACEMSG(
+                "Prepared handler not found, handle: [" + sl::support::to_string(handle) + "]"));
+        return it->second;
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_prepared_handlers, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_prepared_handlers, uint64_t, prepare, (const std::string&)(const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_prepared_handlers, std::shared_ptr<const duktape_prepared_handler>, find, (uint64_t), (const), support::exception)
+
+std::string make_invoke_payload(uint64_t handle, sl::io::span<const char> args) {
+    auto res = std::string();
+    res.push_back(invoke_payload_marker);
+    res.append(sl::support::to_string(handle));
+    res.push_back(invoke_payload_separator);
+    res.append(args.data(), args.size());
+    return res;
+}
+
+bool is_invoke_payload(sl::io::span<const char> data) {
+    return data.size() > 0 && invoke_payload_marker == data.data()[0];
+}
+
+uint64_t parse_invoke_payload(sl::io::span<const char> data, sl::io::span<const char>& args_out) {
+    uint64_t handle = 0;
+    size_t pos = 1;
+    while (pos < data.size() && data.data()[pos] >= '0' && data.data()[pos] <= '9' && handle <= max_handle) {
+        handle = handle * 10 + static_cast<uint64_t> (data.data()[pos] - '0');
+        pos += 1;
+    }
+    // at most one digit past the limit is read, so the check above cannot overflow
+    if (handle > max_handle) throw support::exception(TRACEMSG(
+            "Invalid prepared handler specified in invocation payload, max handle: [" +
+            sl::support::to_string(max_handle) + "]"));
+    if (!is_invoke_payload(data) || 1 == pos || pos >= data.size() ||
+            invoke_payload_separator != data.data()[pos]) throw support::exception(TRACEMSG(
+            "Invalid prepared handler invocation payload specified"));
+    pos += 1;
+    args_out = sl::io::span<const char>(data.data() + pos, data.size() - pos);
+    return handle;
+}
+
+std::shared_ptr<duktape_prepared_handlers> shared_prepared_handlers() {
+    static auto handlers = std::make_shared<duktape_prepared_handlers>();
+    return handlers;
+}
+
+} // namespace
+}
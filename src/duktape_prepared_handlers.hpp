@@ -0,0 +1,117 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_prepared_handlers.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:00 PM
+ */
+
+#ifndef WILTON_DUKTAPE_PREPARED_HANDLERS_HPP
+#define WILTON_DUKTAPE_PREPARED_HANDLERS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/io.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Module function prepared for direct invocation, entries are never
+ * removed, so handles stay valid for all engines
+ */
+class duktape_prepared_handler {
+public:
+    uint64_t handle;
+    std::string module;
+    std::string func;
+
+    duktape_prepared_handler(uint64_t handler_handle, const std::string& handler_module,
+            const std::string& handler_func) :
+    handle(handler_handle),
+    module(handler_module),
+    func(handler_func) { }
+};
+
+/**
+ * Handles of prepared module functions, each engine resolves
+ * the function once on the first invocation and keeps it in its stash
+ */
+class duktape_prepared_handlers : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_prepared_handlers)
+
+    duktape_prepared_handlers();
+
+    /**
+     * Same handle is returned for the same module function
+     *
+     * @param module module name
+     * @param func function name
+     * @return handle
+     */
+    uint64_t prepare(const std::string& module, const std::string& func);
+
+    std::shared_ptr<const duktape_prepared_handler> find(uint64_t handle) const;
+};
+
+/**
+ * Invocation payload is passed through "runscript_duktape" in place
+ * of callback script: "\x01<handle>:<args>", where args are JSON array
+ * or CBOR array with self-describe tag prefix
+ *
+ * @param handle prepared handler handle
+ * @param args arguments array
+ * @return payload
+ */
+std::string make_invoke_payload(uint64_t handle, sl::io::span<const char> args);
+
+bool is_invoke_payload(sl::io::span<const char> data);
+
+/**
+ * Parses invocation payload, throws on invalid input
+ *
+ * @param data payload
+ * @param args_out arguments array, points into payload
+ * @return handle
+ */
+uint64_t parse_invoke_payload(sl::io::span<const char> data, sl::io::span<const char>& args_out);
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_prepared_handlers> shared_prepared_handlers();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_PREPARED_HANDLERS_HPP */
@@ -0,0 +1,488 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/* 
+ * File:   duktape_primitives.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 7:40 PM
+ */
+
+#include "duktape_primitives.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+
+#include "staticlib/io.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const char* builder_buffer_key = "\xff" "wiltonBuilderBuffer";
+const char* builder_length_key = "\xff" "wiltonBuilderLength";
+const uint32_t replacement_char = 0xfffd;
+const char* hex_digits = "0123456789abcdef";
+
+class crc32_table {
+public:
+    uint32_t values[256];
+
+    crc32_table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+            }
+            values[i] = crc;
+        }
+    }
+};
+
+// filled on library load
+const crc32_table crc_table;
+
+sl::io::span<const char> get_bytes(duk_context* ctx, duk_idx_t idx) {
+    if (DUK_TYPE_BUFFER == duk_get_type(ctx, idx) || DUK_TYPE_OBJECT == duk_get_type(ctx, idx)) {
+        duk_size_t len = 0;
+        void* data = duk_get_buffer_data(ctx, idx, std::addressof(len));
+        if (nullptr != data) {
+            return sl::io::span<const char>(static_cast<const char*> (data), len);
+        }
+    }
+    size_t len = 0;
+    const char* str = duk_get_lstring(ctx, idx, std::addressof(len));
+    if (nullptr == str) {
+        throw support::exception(TRACEMSG("Invalid data specified, string or buffer expected"));
+    }
+    return sl::io::span<const char>(str, len);
+}
+
+void push_buffer(duk_context* ctx, const char* data, size_t len) {
+    void* buf = duk_push_fixed_buffer(ctx, len);
+    if (len > 0) {
+        std::memcpy(buf, data, len);
+    }
+}
+
+void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char> (cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char> (0xc0 | (cp >> 6)));
+        out.push_back(static_cast<char> (0x80 | (cp & 0x3f)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char> (0xe0 | (cp >> 12)));
+        out.push_back(static_cast<char> (0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char> (0x80 | (cp & 0x3f)));
+    } else {
+        out.push_back(static_cast<char> (0xf0 | (cp >> 18)));
+        out.push_back(static_cast<char> (0x80 | ((cp >> 12) & 0x3f)));
+        out.push_back(static_cast<char> (0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char> (0x80 | (cp & 0x3f)));
+    }
+}
+
+// lenient decoder, returns replacement char and skips
+// one byte on invalid input, surrogates are allowed
+uint32_t read_code_point(sl::io::span<const char> data, size_t& pos) {
+    auto len = data.size();
+    auto byte = [&data](size_t i) {
+        return static_cast<uint32_t> (static_cast<unsigned char> (data.data()[i]));
+    };
+    auto cont = [&byte, len](size_t i) {
+        return i < len && 0x80 == (byte(i) & 0xc0);
+    };
+    uint32_t b0 = byte(pos);
+    if (b0 < 0x80) {
+        pos += 1;
+        return b0;
+    }
+    if (0xc0 == (b0 & 0xe0) && cont(pos + 1)) {
+        uint32_t cp = ((b0 & 0x1f) << 6) | (byte(pos + 1) & 0x3f);
+        if (cp >= 0x80) {
+            pos += 2;
+            return cp;
+        }
+    } else if (0xe0 == (b0 & 0xf0) && cont(pos + 1) && cont(pos + 2)) {
+        uint32_t cp = ((b0 & 0x0f) << 12) | ((byte(pos + 1) & 0x3f) << 6) | (byte(pos + 2) & 0x3f);
+        if (cp >= 0x800) {
+            pos += 3;
+            return cp;
+        }
+    } else if (0xf0 == (b0 & 0xf8) && cont(pos + 1) && cont(pos + 2) && cont(pos + 3)) {
+        uint32_t cp = ((b0 & 0x07) << 18) | ((byte(pos + 1) & 0x3f) << 12) |
+                ((byte(pos + 2) & 0x3f) << 6) | (byte(pos + 3) & 0x3f);
+        if (cp >= 0x10000 && cp <= 0x10ffff) {
+            pos += 4;
+            return cp;
+        }
+    }
+    pos += 1;
+    return replacement_char;
+}
+
+bool is_high_surrogate(uint32_t cp) {
+    return cp >= 0xd800 && cp <= 0xdbff;
+}
+
+bool is_low_surrogate(uint32_t cp) {
+    return cp >= 0xdc00 && cp <= 0xdfff;
+}
+
+} // namespace
+
+bool is_ascii(sl::io::span<const char> data) {
+    for (size_t i = 0; i < data.size(); i++) {
+        if (0 != (static_cast<unsigned char> (data.data()[i]) & 0x80)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Duktape strings keep non-BMP characters as CESU-8 surrogate pairs
+std::string internal_to_utf8(sl::io::span<const char> data) {
+    auto res = std::string();
+    res.reserve(data.size());
+    size_t pos = 0;
+    while (pos < data.size()) {
+        auto cp = read_code_point(data, pos);
+        if (is_high_surrogate(cp)) {
+            auto next_pos = pos;
+            auto low = next_pos < data.size() ? read_code_point(data, next_pos) : 0;
+            if (is_low_surrogate(low)) {
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                pos = next_pos;
+            } else {
+                cp = replacement_char;
+            }
+        } else if (is_low_surrogate(cp)) {
+            cp = replacement_char;
+        }
+        append_utf8(res, cp);
+    }
+    return res;
+}
+
+std::string utf8_to_internal(sl::io::span<const char> data) {
+    auto res = std::string();
+    res.reserve(data.size());
+    size_t pos = 0;
+    while (pos < data.size()) {
+        auto cp = read_code_point(data, pos);
+        if (is_high_surrogate(cp) || is_low_surrogate(cp)) {
+            // not valid in UTF-8 input
+            cp = replacement_char;
+        }
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            append_utf8(res, 0xd800 + (cp >> 10));
+            append_utf8(res, 0xdc00 + (cp & 0x3ff));
+        } else {
+            append_utf8(res, cp);
+        }
+    }
+    return res;
+}
+
+void push_utf8_as_string(duk_context* ctx, sl::io::span<const char> data) {
+    if (is_ascii(data)) {
+        duk_push_lstring(ctx, data.data(), data.size());
+    } else {
+        auto str = utf8_to_internal(data);
+        duk_push_lstring(ctx, str.data(), str.length());
+    }
+}
+
+namespace { // anonymous
+
+// TextEncoder
+
+duk_ret_t text_encoder_ctor(duk_context* ctx) {
+    if (!duk_is_constructor_call(ctx)) {
+        throw support::exception(TRACEMSG("TextEncoder must be called with 'new'"));
+    }
+    return 0;
+}
+
+// [string] -> [buffer]
+duk_ret_t text_encoder_encode(duk_context* ctx) {
+    if (duk_is_null_or_undefined(ctx, 0)) {
+        duk_push_fixed_buffer(ctx, 0);
+        return 1;
+    }
+    size_t len = 0;
+    const char* str = duk_to_lstring(ctx, 0, std::addressof(len));
+    auto data = sl::io::span<const char>(str, len);
+    if (is_ascii(data)) {
+        push_buffer(ctx, str, len);
+    } else {
+        auto utf8 = internal_to_utf8(data);
+        push_buffer(ctx, utf8.data(), utf8.length());
+    }
+    return 1;
+}
+
+// TextDecoder
+
+duk_ret_t text_decoder_ctor(duk_context* ctx) {
+    if (!duk_is_constructor_call(ctx)) {
+        throw support::exception(TRACEMSG("TextDecoder must be called with 'new'"));
+    }
+    if (!duk_is_null_or_undefined(ctx, 0)) {
+        auto label = std::string(duk_to_string(ctx, 0));
+        std::transform(label.begin(), label.end(), label.begin(), ::tolower);
+        if ("utf-8" != label && "utf8" != label) {
+            throw support::exception(TRACEMSG("Unsupported encoding: [" + label + "]"));
+        }
+    }
+    return 0;
+}
+
+// [buffer] -> [string]
+duk_ret_t text_decoder_decode(duk_context* ctx) {
+    if (duk_is_null_or_undefined(ctx, 0)) {
+        duk_push_string(ctx, "");
+        return 1;
+    }
+    push_utf8_as_string(ctx, get_bytes(ctx, 0));
+    return 1;
+}
+
+// StringBuilder
+
+duk_ret_t string_builder_ctor(duk_context* ctx) {
+    if (!duk_is_constructor_call(ctx)) {
+        throw support::exception(TRACEMSG("StringBuilder must be called with 'new'"));
+    }
+    auto capacity = duk_is_number(ctx, 0) ? duk_get_uint(ctx, 0) : 0;
+    duk_push_this(ctx);
+    duk_push_dynamic_buffer(ctx, capacity);
+    duk_put_prop_string(ctx, -2, builder_buffer_key);
+    duk_push_uint(ctx, 0);
+    duk_put_prop_string(ctx, -2, builder_length_key);
+    return 0;
+}
+
+// pushes [this, buffer], returns builder length
+size_t push_builder(duk_context* ctx) {
+    duk_push_this(ctx);
+    duk_get_prop_string(ctx, -1, builder_buffer_key);
+    if (!duk_is_dynamic_buffer(ctx, -1)) {
+        throw support::exception(TRACEMSG("Invalid StringBuilder instance"));
+    }
+    duk_get_prop_string(ctx, -2, builder_length_key);
+    auto len = static_cast<size_t> (duk_get_uint(ctx, -1));
+    duk_pop(ctx);
+    return len;
+}
+
+// [string|buffer] -> [this], buffers are appended as UTF-8
+duk_ret_t string_builder_append(duk_context* ctx) {
+    auto internal = std::string();
+    auto data = sl::io::span<const char>(nullptr, 0);
+    if (DUK_TYPE_BUFFER == duk_get_type(ctx, 0) || DUK_TYPE_OBJECT == duk_get_type(ctx, 0)) {
+        data = get_bytes(ctx, 0);
+        if (!is_ascii(data)) {
+            internal = utf8_to_internal(data);
+            data = sl::io::span<const char>(internal.data(), internal.length());
+        }
+    } else {
+        size_t str_len = 0;
+        const char* str = duk_to_lstring(ctx, 0, std::addressof(str_len));
+        data = sl::io::span<const char>(str, str_len);
+    }
+    auto len = push_builder(ctx);
+    duk_size_t capacity = 0;
+    void* buf = duk_get_buffer(ctx, -1, std::addressof(capacity));
+    if (len + data.size() > capacity) {
+        auto grown = std::max(len + data.size(), static_cast<size_t> (capacity) * 2);
+        buf = duk_resize_buffer(ctx, -1, grown);
+    }
+    if (data.size() > 0) {
+        std::memcpy(static_cast<char*> (buf) + len, data.data(), data.size());
+    }
+    duk_pop(ctx);
+    duk_push_uint(ctx, static_cast<duk_uint_t> (len + data.size()));
+    duk_put_prop_string(ctx, -2, builder_length_key);
+    return 1;
+}
+
+// [] -> [string]
+duk_ret_t string_builder_to_string(duk_context* ctx) {
+    auto len = push_builder(ctx);
+    duk_size_t capacity = 0;
+    void* buf = duk_get_buffer(ctx, -1, std::addressof(capacity));
+    duk_push_lstring(ctx, static_cast<const char*> (buf), len);
+    return 1;
+}
+
+// [] -> [number]
+duk_ret_t string_builder_byte_length(duk_context* ctx) {
+    auto len = push_builder(ctx);
+    duk_push_uint(ctx, static_cast<duk_uint_t> (len));
+    return 1;
+}
+
+// [] -> [this], capacity is kept
+duk_ret_t string_builder_clear(duk_context* ctx) {
+    push_builder(ctx);
+    duk_pop(ctx);
+    duk_push_uint(ctx, 0);
+    duk_put_prop_string(ctx, -2, builder_length_key);
+    return 1;
+}
+
+// codecs and hashes
+
+// Duktape codecs treat only plain buffers as bytes and coerce
+// everything else to string, so buffer objects are copied into one
+void prepare_codec_input(duk_context* ctx, duk_idx_t idx) {
+    auto data = get_bytes(ctx, idx);
+    if (DUK_TYPE_OBJECT == duk_get_type(ctx, idx)) {
+        push_buffer(ctx, data.data(), data.size());
+        duk_replace(ctx, idx);
+    }
+}
+
+// [string|buffer] -> [string]
+duk_ret_t hex_encode_func(duk_context* ctx) {
+    prepare_codec_input(ctx, 0);
+    duk_hex_encode(ctx, 0);
+    return 1;
+}
+
+// [string] -> [buffer]
+duk_ret_t hex_decode_func(duk_context* ctx) {
+    duk_hex_decode(ctx, 0);
+    return 1;
+}
+
+// [string|buffer] -> [string]
+duk_ret_t base64_encode_func(duk_context* ctx) {
+    prepare_codec_input(ctx, 0);
+    duk_base64_encode(ctx, 0);
+    return 1;
+}
+
+// [string] -> [buffer]
+duk_ret_t base64_decode_func(duk_context* ctx) {
+    duk_base64_decode(ctx, 0);
+    return 1;
+}
+
+// [string|buffer, initial] -> [number]
+duk_ret_t crc32_func(duk_context* ctx) {
+    auto data = get_bytes(ctx, 0);
+    uint32_t crc = duk_is_number(ctx, 1) ? static_cast<uint32_t> (duk_get_uint(ctx, 1)) : 0;
+    crc = ~crc;
+    for (size_t i = 0; i < data.size(); i++) {
+        crc = crc_table.values[(crc ^ static_cast<unsigned char> (data.data()[i])) & 0xff] ^ (crc >> 8);
+    }
+    duk_push_uint(ctx, static_cast<duk_uint_t> (~crc));
+    return 1;
+}
+
+// [string|buffer] -> [number]
+duk_ret_t fnv1a32_func(duk_context* ctx) {
+    auto data = get_bytes(ctx, 0);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < data.size(); i++) {
+        hash ^= static_cast<unsigned char> (data.data()[i]);
+        hash *= 16777619u;
+    }
+    duk_push_uint(ctx, static_cast<duk_uint_t> (hash));
+    return 1;
+}
+
+// [string|buffer] -> [string], 64-bit value doesn't fit into JS number
+duk_ret_t fnv1a64_func(duk_context* ctx) {
+    auto data = get_bytes(ctx, 0);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < data.size(); i++) {
+        hash ^= static_cast<unsigned char> (data.data()[i]);
+        hash *= 1099511628211ull;
+    }
+    char hex[16];
+    for (int i = 15; i >= 0; i--) {
+        hex[i] = hex_digits[hash & 0xf];
+        hash >>= 4;
+    }
+    duk_push_lstring(ctx, hex, sizeof(hex));
+    return 1;
+}
+
+void put_method(duk_context* ctx, const char* name, duk_c_function fun, duk_idx_t nargs) {
+    duk_push_c_function(ctx, fun, nargs);
+    duk_put_prop_string(ctx, -2, name);
+}
+
+// expects prototype on top of the stack, pops it
+void define_class(duk_context* ctx, const char* name, duk_c_function ctor, duk_idx_t nargs) {
+    duk_push_global_object(ctx);
+    duk_push_c_function(ctx, ctor, nargs);
+    duk_dup(ctx, -3);
+    duk_put_prop_string(ctx, -2, "prototype");
+    duk_put_prop_string(ctx, -2, name);
+    duk_pop_2(ctx);
+}
+
+void put_global_func(duk_context* ctx, const char* name, duk_c_function fun, duk_idx_t nargs) {
+    duk_push_global_object(ctx);
+    put_method(ctx, name, fun, nargs);
+    duk_pop(ctx);
+}
+
+} // namespace
+
+void register_native_primitives(duk_context* ctx) {
+    duk_push_object(ctx);
+    duk_push_string(ctx, "utf-8");
+    duk_put_prop_string(ctx, -2, "encoding");
+    put_method(ctx, "encode", text_encoder_encode, 1);
+    define_class(ctx, "TextEncoder", text_encoder_ctor, 0);
+
+    duk_push_object(ctx);
+    duk_push_string(ctx, "utf-8");
+    duk_put_prop_string(ctx, -2, "encoding");
+    put_method(ctx, "decode", text_decoder_decode, 1);
+    define_class(ctx, "TextDecoder", text_decoder_ctor, 1);
+
+    duk_push_object(ctx);
+    put_method(ctx, "append", string_builder_append, 1);
+    put_method(ctx, "toString", string_builder_to_string, 0);
+    put_method(ctx, "byteLength", string_builder_byte_length, 0);
+    put_method(ctx, "clear", string_builder_clear, 0);
+    define_class(ctx, "StringBuilder", string_builder_ctor, 1);
+
+    put_global_func(ctx, "WILTON_hex_encode", hex_encode_func, 1);
+    put_global_func(ctx, "WILTON_hex_decode", hex_decode_func, 1);
+    put_global_func(ctx, "WILTON_base64_encode", base64_encode_func, 1);
+    put_global_func(ctx, "WILTON_base64_decode", base64_decode_func, 1);
+    put_global_func(ctx, "WILTON_crc32", crc32_func, 2);
+    put_global_func(ctx, "WILTON_fnv1a32", fnv1a32_func, 1);
+    put_global_func(ctx, "WILTON_fnv1a64", fnv1a64_func, 1);
+}
+
+} // namespace
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_primitives.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 7:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_PRIMITIVES_HPP
+#define WILTON_DUKTAPE_PRIMITIVES_HPP
+
+#include <string>
+
+#include "duktape.h"
+
+#include "staticlib/io.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Registers native byte and string helpers into the global object:
+ * TextEncoder, TextDecoder, StringBuilder, hex and base64 codecs,
+ * CRC32 and FNV-1a hashes
+ * 
+ * @param ctx Duktape context
+ */
+void register_native_primitives(duk_context* ctx);
+
+bool is_ascii(sl::io::span<const char> data);
+
+/**
+ * Converts Duktape internal string representation, that keeps
+ * non-BMP characters as surrogate pairs, to UTF-8
+ *
+ * @param data internal string bytes
+ * @return UTF-8 string
+ */
+std::string internal_to_utf8(sl::io::span<const char> data);
+
+std::string utf8_to_internal(sl::io::span<const char> data);
+
+void push_utf8_as_string(duk_context* ctx, sl::io::span<const char> data);
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_PRIMITIVES_HPP */
+
@@ -0,0 +1,326 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_scheduler.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 9:00 PM
+ */
+
+#include "duktape_scheduler.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "duktape_config.hpp"
+#include "duktape_worker_pool.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const uint32_t default_max_queued = 1024;
+
+uint32_t limit_or_max(uint32_t limit) {
+    return 0 != limit ? limit : std::numeric_limits<uint32_t>::max();
+}
+
+uint64_t current_epoch_millis() {
+    auto now = std::chrono::system_clock::now();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count());
+}
+
+class waiter {
+public:
+    bool ready = false;
+};
+
+class priority_class {
+public:
+    std::string name;
+    uint32_t max_concurrent;
+    uint32_t max_queued;
+    uint32_t running = 0;
+    // waiting callers in arrival order
+    std::deque<waiter*> queue;
+    uint64_t peak_queued = 0;
+    uint64_t admitted = 0;
+    uint64_t rejected_deadline = 0;
+    uint64_t rejected_queue_full = 0;
+    uint64_t wait_millis_total = 0;
+    uint64_t wait_millis_max = 0;
+
+    priority_class(const std::string& name, uint32_t max_concurrent, uint32_t max_queued) :
+    name(name),
+    max_concurrent(limit_or_max(max_concurrent)),
+    max_queued(limit_or_max(max_queued)) { }
+};
+
+} // namespace
+
+class duktape_scheduler::impl : public sl::pimpl::object::impl {
+    uint32_t max_concurrent;
+    size_t default_class_idx = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    // ordered by priority, highest first
+    std::vector<priority_class> classes;
+    uint32_t running = 0;
+    // threads that hold a slot, their nested calls are not queued
+    std::unordered_map<std::thread::id, uint32_t> holders;
+
+public:
+    impl(const sl::json::value& config) :
+    max_concurrent(limit_or_max(config["maxConcurrent"].as_uint32(0))) {
+        for (auto& en : config["classes"].as_array()) {
+            auto& name = en["name"].as_string_nonempty_or_throw("scheduler.classes.name");
+            for (auto& pc : classes) {
+                if (name == pc.name) throw support::exception(TRACEMSG(
+                        "Duplicate priority class specified, name: [" + name + "]"));
+            }
+            classes.emplace_back(name, en["maxConcurrent"].as_uint32(0),
+                    en["maxQueued"].as_uint32(default_max_queued));
+        }
+        auto& default_class = config["defaultClass"].as_string();
+        if (!classes.empty()) {
+            // lowest priority is used for unmarked calls by default
+            default_class_idx = classes.size() - 1;
+            if (!default_class.empty()) {
+                default_class_idx = find_class(default_class);
+                if (classes.size() == default_class_idx) throw support::exception(TRACEMSG(
+                        "Invalid default priority class specified, name: [" + default_class + "]"));
+            }
+        }
+    }
+
+    bool is_enabled(const duktape_scheduler&) const {
+        return !classes.empty();
+    }
+
+    support::buffer run_script(duktape_scheduler&, const duktape_callback_info& info,
+            sl::io::span<const char> callback_script,
+            std::function<support::buffer(sl::io::span<const char>)> runner) {
+        if (classes.empty() || shared_worker_pool()->is_worker_thread()) {
+            return runner(callback_script);
+        }
+        auto idx = default_class_idx;
+        if (!info.priority.empty()) {
+            auto found = find_class(info.priority);
+            if (classes.size() != found) {
+                idx = found;
+            }
+        }
+        auto deadline = info.deadline;
+        auto tid = std::this_thread::get_id();
+        acquire(idx, deadline, tid);
+        auto deferred = sl::support::defer([this, idx, tid]() STATICLIB_NOEXCEPT {
+            release(idx, tid);
+        });
+        return runner(callback_script);
+    }
+
+    sl::json::value stats(const duktape_scheduler&) const {
+        if (classes.empty()) {
+            return sl::json::value({
+                { "enabled", false }
+            });
+        }
+        auto classes_json = std::vector<sl::json::value>();
+        std::lock_guard<std::mutex> guard{mutex};
+        for (auto& pc : classes) {
+            classes_json.emplace_back(sl::json::value({
+                { "name", pc.name },
+                { "maxConcurrent", limit_to_json(pc.max_concurrent) },
+                { "maxQueued", limit_to_json(pc.max_queued) },
+                { "running", static_cast<int64_t> (pc.running) },
+                { "queued", static_cast<int64_t> (pc.queue.size()) },
+                { "peakQueued", static_cast<int64_t> (pc.peak_queued) },
+                { "admitted", static_cast<int64_t> (pc.admitted) },
+                { "rejectedDeadline", static_cast<int64_t> (pc.rejected_deadline) },
+                { "rejectedQueueFull", static_cast<int64_t> (pc.rejected_queue_full) },
+                { "waitMillisTotal", static_cast<int64_t> (pc.wait_millis_total) },
+                { "waitMillisMax", static_cast<int64_t> (pc.wait_millis_max) }
+            }));
+        }
+        return sl::json::value({
+            { "enabled", true },
+            { "maxConcurrent", limit_to_json(max_concurrent) },
+            { "running", static_cast<int64_t> (running) },
+            { "defaultClass", classes[default_class_idx].name },
+            { "classes", std::move(classes_json) }
+        });
+    }
+
+private:
+    size_t find_class(const std::string& name) const {
+        for (size_t i = 0; i < classes.size(); i++) {
+            if (name == classes[i].name) {
+                return i;
+            }
+        }
+        return classes.size();
+    }
+
+    static int64_t limit_to_json(uint32_t limit) {
+        return std::numeric_limits<uint32_t>::max() != limit ? static_cast<int64_t> (limit) : 0;
+    }
+
+    void acquire(size_t idx, uint64_t deadline, std::thread::id tid) {
+        auto& pc = classes[idx];
+        std::unique_lock<std::mutex> guard{mutex};
+        auto hit = holders.find(tid);
+        if (holders.end() != hit) {
+            // nested call from a running callback, slot is already held
+            pc.admitted += 1;
+            take_slot(pc, tid);
+            return;
+        }
+        if (0 != deadline && current_epoch_millis() >= deadline) {
+            pc.rejected_deadline += 1;
+            throw support::exception(TRACEMSG(
+                    "Call deadline expired before start, priority class: [" + pc.name + "]"));
+        }
+        if (pc.queue.empty() && can_start(idx)) {
+            pc.admitted += 1;
+            take_slot(pc, tid);
+            return;
+        }
+        if (pc.queue.size() >= pc.max_queued) {
+            pc.rejected_queue_full += 1;
+            throw support::exception(TRACEMSG(
+                    "Call queue is full, priority class: [" + pc.name + "]," +
+                    " max queued: [" + sl::support::to_string(pc.max_queued) + "]"));
+        }
+        auto wt = waiter();
+        pc.queue.push_back(std::addressof(wt));
+        if (pc.queue.size() > pc.peak_queued) {
+            pc.peak_queued = pc.queue.size();
+        }
+        auto started = std::chrono::steady_clock::now();
+        auto pred = [&wt] {
+            return wt.ready;
+        };
+        if (0 != deadline) {
+            auto now_epoch = current_epoch_millis();
+            auto left = deadline > now_epoch ? deadline - now_epoch : 0;
+            cv.wait_for(guard, std::chrono::milliseconds(left), pred);
+        } else {
+            cv.wait(guard, pred);
+        }
+        auto waited = static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count());
+        pc.wait_millis_total += waited;
+        if (waited > pc.wait_millis_max) {
+            pc.wait_millis_max = waited;
+        }
+        if (!wt.ready) {
+            for (auto it = pc.queue.begin(); it != pc.queue.end(); ++it) {
+                if (std::addressof(wt) == *it) {
+                    pc.queue.erase(it);
+                    break;
+                }
+            }
+            pc.rejected_deadline += 1;
+            // next waiter may become eligible
+            dispatch();
+            throw support::exception(TRACEMSG(
+                    "Call cannot be started before its deadline, priority class: [" + pc.name + "]," +
+                    " waited millis: [" + sl::support::to_string(waited) + "]"));
+        }
+        // slot was taken by dispatch on behalf of this waiter
+        holders[tid] += 1;
+        pc.admitted += 1;
+    }
+
+    void release(size_t idx, std::thread::id tid) STATICLIB_NOEXCEPT {
+        std::lock_guard<std::mutex> guard{mutex};
+        classes[idx].running -= 1;
+        running -= 1;
+        auto it = holders.find(tid);
+        it->second -= 1;
+        if (0 == it->second) {
+            holders.erase(it);
+        }
+        dispatch();
+    }
+
+    void take_slot(priority_class& pc, std::thread::id tid) {
+        pc.running += 1;
+        running += 1;
+        holders[tid] += 1;
+    }
+
+    bool can_start(size_t idx) const {
+        if (running >= max_concurrent || classes[idx].running >= classes[idx].max_concurrent) {
+            return false;
+        }
+        // higher priority waiters, that can run in their class, go first
+        for (size_t i = 0; i < idx; i++) {
+            auto& hp = classes[i];
+            if (!hp.queue.empty() && hp.running < hp.max_concurrent) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // called under lock, hands free slots to queue heads in priority order
+    void dispatch() {
+        auto woken = false;
+        for (size_t i = 0; i < classes.size() && running < max_concurrent; i++) {
+            auto& pc = classes[i];
+            while (!pc.queue.empty() && running < max_concurrent && pc.running < pc.max_concurrent) {
+                pc.queue.front()->ready = true;
+                pc.queue.pop_front();
+                pc.running += 1;
+                running += 1;
+                woken = true;
+            }
+        }
+        if (woken) {
+            cv.notify_all();
+        }
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_scheduler, (const sl::json::value&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_scheduler, bool, is_enabled, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_scheduler, support::buffer, run_script, (const duktape_callback_info&)(sl::io::span<const char>)(std::function<support::buffer(sl::io::span<const char>)>), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_scheduler, sl::json::value, stats, (), (const), support::exception)
+
+std::shared_ptr<duktape_scheduler> shared_scheduler() {
+    static auto scheduler = [] {
+        auto cf = load_duktape_config();
+        return std::make_shared<duktape_scheduler>(cf["scheduler"]);
+    } ();
+    return scheduler;
+}
+
+} // namespace
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_scheduler.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 9:00 PM
+ */
+
+#ifndef WILTON_DUKTAPE_SCHEDULER_HPP
+#define WILTON_DUKTAPE_SCHEDULER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/buffer.hpp"
+#include "wilton/support/exception.hpp"
+
+#include "duktape_callback_info.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Admission control in front of the engines map, callback scripts are
+ * started in order of their priority classes, "priority" and "deadline"
+ * (Unix epoch millis) are read from the JSON or CBOR callback script
+ */
+class duktape_scheduler : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_scheduler)
+
+    /**
+     * Config format: {"maxConcurrent": 16, "defaultClass": "batch", "classes": [
+     * {"name": "interactive", "maxConcurrent": 16, "maxQueued": 1024},
+     * {"name": "batch", "maxConcurrent": 4, "maxQueued": 256}]}, classes are
+     * listed from the highest priority to the lowest one, zero limits mean
+     * no limit, scheduler is disabled when no classes are specified
+     *
+     * @param config scheduler config
+     */
+    duktape_scheduler(const sl::json::value& config);
+
+    bool is_enabled() const;
+
+    /**
+     * Waits for a free slot in the specified priority class, throws if
+     * the call cannot be started before its deadline or the queue is full,
+     * nested calls from running callbacks and from worker pool threads
+     * are not queued to not wait for the slots held by their callers
+     *
+     * @param info callback info read from the script
+     * @param callback_script callback script
+     * @param runner function running the script in engine
+     * @return script result
+     */
+    support::buffer run_script(const duktape_callback_info& info, sl::io::span<const char> callback_script,
+            std::function<support::buffer(sl::io::span<const char>)> runner);
+
+    sl::json::value stats() const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_scheduler> shared_scheduler();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_SCHEDULER_HPP */
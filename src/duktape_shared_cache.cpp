@@ -0,0 +1,274 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_shared_cache.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 2:40 PM
+ */
+
+#include "duktape_shared_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "duktape_config.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+// approximate per-entry bookkeeping cost
+const uint64_t entry_overhead_bytes = 96;
+const uint64_t default_max_bytes = 64 * 1024 * 1024;
+const uint32_t default_shards_count = 16;
+
+uint64_t current_time_millis() {
+    auto now = std::chrono::steady_clock::now();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count());
+}
+
+uint64_t entry_cost(const std::string& key, const duktape_cache_value& value) {
+    return key.length() + value.data.length() + entry_overhead_bytes;
+}
+
+class cache_entry {
+public:
+    std::shared_ptr<const duktape_cache_value> value;
+    uint64_t expires_at;
+    uint64_t cost;
+    std::list<std::string>::iterator lru_it;
+
+    cache_entry(std::shared_ptr<const duktape_cache_value> entry_value, uint64_t entry_expires_at,
+            uint64_t entry_cost, std::list<std::string>::iterator entry_lru_it) :
+    value(std::move(entry_value)),
+    expires_at(entry_expires_at),
+    cost(entry_cost),
+    lru_it(entry_lru_it) { }
+};
+
+class cache_shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, cache_entry> entries;
+    // most recently used keys are in front
+    std::list<std::string> lru;
+    uint64_t bytes = 0;
+    uint64_t max_bytes;
+
+public:
+    std::atomic<uint64_t> evictions;
+
+    cache_shard(uint64_t shard_max_bytes) :
+    max_bytes(shard_max_bytes) {
+        evictions.store(0, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<const duktape_cache_value> get(const std::string& key) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = entries.find(key);
+        if (entries.end() == it) {
+            return std::shared_ptr<const duktape_cache_value>();
+        }
+        if (0 != it->second.expires_at && it->second.expires_at <= current_time_millis()) {
+            erase(it);
+            return std::shared_ptr<const duktape_cache_value>();
+        }
+        lru.splice(lru.begin(), lru, it->second.lru_it);
+        return it->second.value;
+    }
+
+    bool put(const std::string& key, std::shared_ptr<const duktape_cache_value> value, uint64_t ttl_millis) {
+        auto cost = entry_cost(key, *value);
+        if (cost > max_bytes) {
+            return false;
+        }
+        uint64_t expires_at = 0 != ttl_millis ? current_time_millis() + ttl_millis : 0;
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = entries.find(key);
+        if (entries.end() != it) {
+            erase(it);
+        }
+        lru.push_front(key);
+        entries.insert(std::make_pair(key, cache_entry(std::move(value), expires_at, cost, lru.begin())));
+        bytes += cost;
+        while (bytes > max_bytes) {
+            auto last = entries.find(lru.back());
+            erase(last);
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    bool remove(const std::string& key) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = entries.find(key);
+        if (entries.end() == it) {
+            return false;
+        }
+        erase(it);
+        return true;
+    }
+
+    uint64_t remove_prefix(const std::string& prefix) {
+        std::lock_guard<std::mutex> guard{mutex};
+        uint64_t count = 0;
+        for (auto it = entries.begin(); it != entries.end();) {
+            auto cur = it++;
+            if (0 == cur->first.compare(0, prefix.length(), prefix)) {
+                erase(cur);
+                count += 1;
+            }
+        }
+        return count;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard{mutex};
+        entries.clear();
+        lru.clear();
+        bytes = 0;
+    }
+
+    std::pair<uint64_t, uint64_t> size() {
+        std::lock_guard<std::mutex> guard{mutex};
+        return std::make_pair(static_cast<uint64_t> (entries.size()), bytes);
+    }
+
+private:
+    void erase(std::unordered_map<std::string, cache_entry>::iterator it) {
+        bytes -= it->second.cost;
+        lru.erase(it->second.lru_it);
+        entries.erase(it);
+    }
+};
+
+} // namespace
+
+class duktape_shared_cache::impl : public sl::pimpl::object::impl {
+    std::vector<std::unique_ptr<cache_shard>> shards;
+    uint64_t max_bytes;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+
+public:
+    impl(uint64_t max_bytes, uint32_t shards_count) :
+    max_bytes(max_bytes) {
+        if (0 == shards_count) throw support::exception(TRACEMSG(
+                "Invalid zero cache shards count specified"));
+        for (uint32_t i = 0; i < shards_count; i++) {
+            shards.emplace_back(sl::support::make_unique<cache_shard>(max_bytes / shards_count));
+        }
+        hits.store(0, std::memory_order_relaxed);
+        misses.store(0, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<const duktape_cache_value> get(duktape_shared_cache&, const std::string& key) {
+        auto res = shard_for(key).get(key);
+        if (nullptr != res.get()) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    bool put(duktape_shared_cache&, const std::string& key, std::shared_ptr<const duktape_cache_value> value,
+            uint64_t ttl_millis) {
+        if (nullptr == value.get()) throw support::exception(TRACEMSG(
+                "Invalid null cache value specified, key: [" + key + "]"));
+        return shard_for(key).put(key, std::move(value), ttl_millis);
+    }
+
+    bool remove(duktape_shared_cache&, const std::string& key) {
+        return shard_for(key).remove(key);
+    }
+
+    uint64_t remove_prefix(duktape_shared_cache&, const std::string& prefix) {
+        uint64_t count = 0;
+        for (auto& sh : shards) {
+            count += sh->remove_prefix(prefix);
+        }
+        return count;
+    }
+
+    void clear(duktape_shared_cache&) {
+        for (auto& sh : shards) {
+            sh->clear();
+        }
+    }
+
+    sl::json::value stats(const duktape_shared_cache&) const {
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        uint64_t evictions = 0;
+        for (auto& sh : shards) {
+            auto size = sh->size();
+            entries += size.first;
+            bytes += size.second;
+            evictions += sh->evictions.load(std::memory_order_relaxed);
+        }
+        return sl::json::value({
+            { "entries", static_cast<int64_t> (entries) },
+            { "bytes", static_cast<int64_t> (bytes) },
+            { "maxBytes", static_cast<int64_t> (max_bytes) },
+            { "hits", static_cast<int64_t> (hits.load(std::memory_order_relaxed)) },
+            { "misses", static_cast<int64_t> (misses.load(std::memory_order_relaxed)) },
+            { "evictions", static_cast<int64_t> (evictions) }
+        });
+    }
+
+private:
+    cache_shard& shard_for(const std::string& key) const {
+        auto hash = std::hash<std::string>()(key);
+        return *shards[hash % shards.size()];
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_shared_cache, (uint64_t)(uint32_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_shared_cache, std::shared_ptr<const duktape_cache_value>, get, (const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_shared_cache, bool, put, (const std::string&)(std::shared_ptr<const duktape_cache_value>)(uint64_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_shared_cache, bool, remove, (const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_shared_cache, uint64_t, remove_prefix, (const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_shared_cache, void, clear, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_shared_cache, sl::json::value, stats, (), (const), support::exception)
+
+std::shared_ptr<duktape_shared_cache> shared_cache() {
+    static auto cache = [] {
+        auto cf = load_duktape_config();
+        auto& cc = cf["sharedCache"];
+        auto max_bytes = cc["maxBytes"].as_int64(static_cast<int64_t> (default_max_bytes));
+        if (max_bytes <= 0) throw support::exception(TRACEMSG(
+                "Invalid 'sharedCache.maxBytes' specified, must be positive, value: [" +
+                sl::support::to_string(max_bytes) + "]"));
+        auto shards_count = cc["shards"].as_uint32(default_shards_count);
+        return std::make_shared<duktape_shared_cache>(static_cast<uint64_t> (max_bytes), shards_count);
+    } ();
+    return cache;
+}
+
+} // namespace
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_shared_cache.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 2:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_SHARED_CACHE_HPP
+#define WILTON_DUKTAPE_SHARED_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Immutable value stored in cache, shared between all engines
+ */
+class duktape_cache_value {
+public:
+    const std::string data;
+    const bool binary;
+
+    duktape_cache_value(std::string&& value_data, bool value_binary) :
+    data(std::move(value_data)),
+    binary(value_binary) { }
+};
+
+/**
+ * Process-wide key/value cache with LRU eviction, memory budget
+ * is split evenly between shards to keep lock contention low
+ */
+class duktape_shared_cache : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_shared_cache)
+
+    duktape_shared_cache(uint64_t max_bytes, uint32_t shards_count);
+
+    std::shared_ptr<const duktape_cache_value> get(const std::string& key);
+
+    /**
+     * Zero TTL means that entry doesn't expire
+     *
+     * @return false if value is too large to be cached
+     */
+    bool put(const std::string& key, std::shared_ptr<const duktape_cache_value> value, uint64_t ttl_millis);
+
+    bool remove(const std::string& key);
+
+    /**
+     * Scans all entries, not intended for per-request use
+     *
+     * @return number of removed entries
+     */
+    uint64_t remove_prefix(const std::string& prefix);
+
+    void clear();
+
+    sl::json::value stats() const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_shared_cache> shared_cache();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_SHARED_CACHE_HPP */
+
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_source_loader.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:10 PM
+ */
+
+#include "duktape_source_loader.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/wiltoncall.h"
+
+#include "wilton/support/exception.hpp"
+
+#include "duktape_config.hpp"
+#include "duktape_platform.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const std::string file_proto_prefix = "file://";
+const uint64_t default_max_cached_bytes = 64 * 1024 * 1024;
+
+bool is_file_path(const std::string& path) {
+    return 0 == path.compare(0, file_proto_prefix.length(), file_proto_prefix);
+}
+
+class cached_source {
+public:
+    std::shared_ptr<const duktape_module_source> source;
+    // "file://" sources only
+    uint64_t file_size;
+    int64_t file_mtime;
+
+    cached_source(std::shared_ptr<const duktape_module_source> source, uint64_t file_size,
+            int64_t file_mtime) :
+    source(std::move(source)),
+    file_size(file_size),
+    file_mtime(file_mtime) { }
+};
+
+} // namespace
+
+duktape_module_source::~duktape_module_source() STATICLIB_NOEXCEPT {
+    if (mapped) {
+        unmap_file(data_ptr, data_len);
+    } else {
+        wilton_free(const_cast<char*> (data_ptr));
+    }
+}
+
+class duktape_source_loader::impl : public sl::pimpl::object::impl {
+    bool map_files;
+    bool cache_sources;
+    uint64_t max_cached_bytes;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, cached_source> sources;
+    uint64_t cached_bytes = 0;
+
+public:
+    impl(bool map_files, bool cache_sources, uint64_t max_cached_bytes) :
+    map_files(map_files),
+    cache_sources(cache_sources),
+    max_cached_bytes(max_cached_bytes) { }
+
+    std::shared_ptr<const duktape_module_source> load(duktape_source_loader&, const std::string& path) {
+        if (!cache_sources) {
+            return load_uncached(path);
+        }
+        // resources in ZIP bundles cannot change while the app is running
+        bool file = is_file_path(path);
+        uint64_t file_size = 0;
+        int64_t file_mtime = 0;
+        if (file && !file_version(path.substr(file_proto_prefix.length()), file_size, file_mtime)) {
+            // cannot check for changes, loading error is reported by the loader
+            return load_uncached(path);
+        }
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            auto it = sources.find(path);
+            if (sources.end() != it) {
+                auto& cs = it->second;
+                // truncated mapped file is detected here before the source is compiled
+                if (cs.file_size == file_size && cs.file_mtime == file_mtime) {
+                    return cs.source;
+                }
+                // file was changed after it was cached
+                cached_bytes -= cs.source->size();
+                sources.erase(it);
+            }
+        }
+        // file may change after its version is read, such source is reloaded on the next call
+        auto src = load_uncached(path);
+        std::lock_guard<std::mutex> guard{mutex};
+        // another thread may have loaded the same source concurrently
+        auto it = sources.find(path);
+        if (sources.end() != it) {
+            cached_bytes -= it->second.source->size();
+            sources.erase(it);
+        }
+        // mapping larger than the file recorded in cache can be accessed past the end
+        bool consistent = !file || src->size() == file_size;
+        if (consistent && src->size() <= max_cached_bytes - cached_bytes) {
+            sources.emplace(path, cached_source(src, file_size, file_mtime));
+            cached_bytes += src->size();
+        }
+        return src;
+    }
+
+private:
+    std::shared_ptr<const duktape_module_source> load_uncached(const std::string& path) {
+        if (map_files && is_file_path(path)) {
+            size_t size = 0;
+            const char* data = map_file_readonly(path.substr(file_proto_prefix.length()), size);
+            if (nullptr != data) {
+                return std::make_shared<duktape_module_source>(data, size, true);
+            }
+            // fall back to the regular loading
+        }
+        char* code = nullptr;
+        int code_len = 0;
+        auto err = wilton_load_resource(path.c_str(), static_cast<int>(path.length()),
+                std::addressof(code), std::addressof(code_len));
+        if (nullptr != err) {
+            support::throw_wilton_error(err, TRACEMSG(err));
+        }
+        return std::make_shared<duktape_module_source>(code, static_cast<size_t> (code_len), false);
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_source_loader, (bool)(bool)(uint64_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_source_loader, std::shared_ptr<const duktape_module_source>, load, (const std::string&), (), support::exception)
+
+std::shared_ptr<duktape_source_loader> shared_source_loader() {
+    static auto loader = [] {
+        auto cf = load_duktape_config();
+        auto& sc = cf["moduleSources"];
+        auto max_bytes = sc["sharedCacheMaxBytes"].as_int64(static_cast<int64_t> (default_max_cached_bytes));
+        if (max_bytes <= 0) throw support::exception(TRACEMSG(
+                "Invalid 'moduleSources.sharedCacheMaxBytes' specified, must be positive, value: [" +
+                sl::support::to_string(max_bytes) + "]"));
+        return std::make_shared<duktape_source_loader>(sc["mapFiles"].as_bool(false),
+                sc["sharedCache"].as_bool(false), static_cast<uint64_t> (max_bytes));
+    } ();
+    return loader;
+}
+
+} // namespace
+}
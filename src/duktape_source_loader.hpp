@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_source_loader.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:10 PM
+ */
+
+#ifndef WILTON_DUKTAPE_SOURCE_LOADER_HPP
+#define WILTON_DUKTAPE_SOURCE_LOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Read-only module source, either memory-mapped or loaded
+ * with "wilton_load_resource"
+ */
+class duktape_module_source {
+    const char* data_ptr;
+    size_t data_len;
+    bool mapped;
+
+public:
+    duktape_module_source(const char* data, size_t size, bool memory_mapped) :
+    data_ptr(data),
+    data_len(size),
+    mapped(memory_mapped) { }
+
+    duktape_module_source(const duktape_module_source&) = delete;
+
+    duktape_module_source& operator=(const duktape_module_source&) = delete;
+
+    ~duktape_module_source() STATICLIB_NOEXCEPT;
+
+    const char* data() const {
+        return data_ptr;
+    }
+
+    size_t size() const {
+        return data_len;
+    }
+};
+
+/**
+ * Loads module sources, "file://" sources can be memory-mapped and
+ * loaded sources can be kept in a cache shared between all engines,
+ * cached "file://" sources are reloaded when file size or modification
+ * time changes
+ */
+class duktape_source_loader : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_source_loader)
+
+    /**
+     * @param map_files map "file://" sources into memory
+     * @param cache_sources keep loaded sources in the shared cache
+     * @param max_cached_bytes max total size of cached sources,
+     *        sources over this limit are loaded without caching
+     */
+    duktape_source_loader(bool map_files, bool cache_sources, uint64_t max_cached_bytes);
+
+    std::shared_ptr<const duktape_module_source> load(const std::string& path);
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_source_loader> shared_source_loader();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_SOURCE_LOADER_HPP */
+
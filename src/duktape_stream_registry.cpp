@@ -0,0 +1,216 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_stream_registry.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:20 AM
+ */
+
+#include "duktape_stream_registry.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/wilton.h"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+class sink_entry {
+public:
+    void* ctx;
+    sink_write_callback cb;
+
+    sink_entry(void* sink_ctx, sink_write_callback write_cb) :
+    ctx(sink_ctx),
+    cb(write_cb) { }
+};
+
+class source_entry {
+public:
+    void* ctx;
+    source_read_callback cb;
+    // set for memory-backed sources only
+    std::shared_ptr<void> holder;
+
+    source_entry(void* source_ctx, source_read_callback read_cb, std::shared_ptr<void> ctx_holder) :
+    ctx(source_ctx),
+    cb(read_cb),
+    holder(std::move(ctx_holder)) { }
+};
+
+class memory_source {
+    std::mutex mutex;
+    sl::io::span<const char> data;
+    size_t offset = 0;
+
+public:
+    memory_source(sl::io::span<const char> source_data) :
+    data(source_data) { }
+
+    int read(char* buffer, int buffer_len) {
+        std::lock_guard<std::mutex> guard{mutex};
+        size_t avail = data.size() - offset;
+        size_t len = avail < static_cast<size_t> (buffer_len) ? avail : static_cast<size_t> (buffer_len);
+        if (len > 0) {
+            std::memcpy(buffer, data.data() + offset, len);
+            offset += len;
+        }
+        return static_cast<int> (len);
+    }
+};
+
+char* memory_source_read_cb(void* source_ctx, char* buffer, int buffer_len, int* read_out) {
+    auto source = static_cast<memory_source*> (source_ctx);
+    *read_out = source->read(buffer, buffer_len);
+    return nullptr;
+}
+
+} // namespace
+
+class duktape_stream_registry::impl : public sl::pimpl::object::impl {
+    std::mutex mutex;
+    std::unordered_map<std::string, sink_entry> sinks;
+    std::unordered_map<std::string, source_entry> sources;
+
+public:
+    impl() { }
+
+    void register_sink(duktape_stream_registry&, const std::string& name, void* sink_ctx,
+            sink_write_callback write_cb) {
+        if (name.empty()) throw support::exception(TRACEMSG(
+                "Invalid empty sink name specified"));
+        if (nullptr == write_cb) throw support::exception(TRACEMSG(
+                "Invalid null write callback specified, sink: [" + name + "]"));
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = sinks.insert(std::make_pair(name, sink_entry(sink_ctx, write_cb)));
+        if (!res.second) throw support::exception(TRACEMSG(
+                "Sink is already registered, name: [" + name + "]"));
+    }
+
+    void unregister_sink(duktape_stream_registry&, const std::string& name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto erased = sinks.erase(name);
+        if (0 == erased) throw support::exception(TRACEMSG(
+                "Sink not found, name: [" + name + "]"));
+    }
+
+    void write_to_sink(duktape_stream_registry&, const std::string& name, sl::io::span<const char> chunk) {
+        auto sink = find_sink(name);
+        if (0 == chunk.size()) {
+            return;
+        }
+        // callback is called without the lock held,
+        // so blocking sink doesn't stall other writers
+        auto err = sink.cb(sink.ctx, chunk.data(), static_cast<int> (chunk.size()));
+        if (nullptr != err) {
+            auto msg = TRACEMSG(err + "\nSink write error, name: [" + name + "]," +
+                    " chunk length: [" + sl::support::to_string(chunk.size()) + "]");
+            wilton_free(err);
+            throw support::exception(msg);
+        }
+    }
+
+    void register_source(duktape_stream_registry&, const std::string& name, void* source_ctx,
+            source_read_callback read_cb) {
+        if (nullptr == read_cb) throw support::exception(TRACEMSG(
+                "Invalid null read callback specified, source: [" + name + "]"));
+        add_source(name, source_entry(source_ctx, read_cb, std::shared_ptr<void>()));
+    }
+
+    void register_memory_source(duktape_stream_registry&, const std::string& name,
+            sl::io::span<const char> data) {
+        auto source = std::make_shared<memory_source>(data);
+        add_source(name, source_entry(source.get(), memory_source_read_cb, source));
+    }
+
+    void unregister_source(duktape_stream_registry&, const std::string& name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto erased = sources.erase(name);
+        if (0 == erased) throw support::exception(TRACEMSG(
+                "Source not found, name: [" + name + "]"));
+    }
+
+    size_t read_from_source(duktape_stream_registry&, const std::string& name, sl::io::span<char> buffer) {
+        auto source = find_source(name);
+        if (0 == buffer.size()) {
+            return 0;
+        }
+        int read = 0;
+        auto err = source.cb(source.ctx, buffer.data(), static_cast<int> (buffer.size()), std::addressof(read));
+        if (nullptr != err) {
+            auto msg = TRACEMSG(err + "\nSource read error, name: [" + name + "]," +
+                    " buffer length: [" + sl::support::to_string(buffer.size()) + "]");
+            wilton_free(err);
+            throw support::exception(msg);
+        }
+        if (read < 0 || static_cast<size_t> (read) > buffer.size()) throw support::exception(TRACEMSG(
+                "Invalid read length returned by source, name: [" + name + "]," +
+                " length: [" + sl::support::to_string(read) + "]"));
+        return static_cast<size_t> (read);
+    }
+
+private:
+    void add_source(const std::string& name, source_entry entry) {
+        if (name.empty()) throw support::exception(TRACEMSG(
+                "Invalid empty source name specified"));
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = sources.insert(std::make_pair(name, std::move(entry)));
+        if (!res.second) throw support::exception(TRACEMSG(
+                "Source is already registered, name: [" + name + "]"));
+    }
+
+    source_entry find_source(const std::string& name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = sources.find(name);
+        if (sources.end() == it) throw support::exception(TRACEMSG(
+                "Source not found, name: [" + name + "]"));
+        return it->second;
+    }
+
+    sink_entry find_sink(const std::string& name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = sinks.find(name);
+        if (sinks.end() == it) throw support::exception(TRACEMSG(
+                "Sink not found, name: [" + name + "]"));
+        return it->second;
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_stream_registry, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, void, register_sink, (const std::string&)(void*)(sink_write_callback), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, void, unregister_sink, (const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, void, write_to_sink, (const std::string&)(sl::io::span<const char>), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, void, register_source, (const std::string&)(void*)(source_read_callback), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, void, register_memory_source, (const std::string&)(sl::io::span<const char>), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, void, unregister_source, (const std::string&), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_stream_registry, size_t, read_from_source, (const std::string&)(sl::io::span<char>), (), support::exception)
+
+std::shared_ptr<duktape_stream_registry> shared_stream_registry() {
+    static auto registry = std::make_shared<duktape_stream_registry>();
+    return registry;
+}
+
+} // namespace
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_stream_registry.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:20 AM
+ */
+
+#ifndef WILTON_DUKTAPE_STREAM_REGISTRY_HPP
+#define WILTON_DUKTAPE_STREAM_REGISTRY_HPP
+
+#include <memory>
+#include <string>
+
+#include "staticlib/io.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Native callback, that receives chunks written by JS code,
+ * returns error message allocated with "wilton_alloc" on failure
+ */
+typedef char* (*sink_write_callback)(void* sink_ctx, const char* data, int data_len);
+
+/**
+ * Native callback, that reads chunks requested by JS code,
+ * returns error message allocated with "wilton_alloc" on failure
+ */
+typedef char* (*source_read_callback)(void* source_ctx, char* buffer, int buffer_len, int* read_out);
+
+class duktape_stream_registry : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_stream_registry)
+
+    duktape_stream_registry();
+
+    void register_sink(const std::string& name, void* sink_ctx, sink_write_callback write_cb);
+
+    void unregister_sink(const std::string& name);
+
+    void write_to_sink(const std::string& name, sl::io::span<const char> chunk);
+
+    void register_source(const std::string& name, void* source_ctx, source_read_callback read_cb);
+
+    void register_memory_source(const std::string& name, sl::io::span<const char> data);
+
+    void unregister_source(const std::string& name);
+
+    size_t read_from_source(const std::string& name, sl::io::span<char> buffer);
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_stream_registry> shared_stream_registry();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_STREAM_REGISTRY_HPP */
+
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_teardown.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:30 PM
+ */
+
+#include "duktape_teardown.hpp"
+
+#include <atomic>
+#include <chrono>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/logging.hpp"
+
+#include "duktape_config.hpp"
+#include "duktape_worker_pool.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const std::string logger = std::string("wilton.engine.duktape.teardown");
+
+void destroy_and_log(duk_context* ctx) {
+    auto start = std::chrono::steady_clock::now();
+    duk_destroy_heap(ctx);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    wilton::support::log_debug(logger, "Heap destroyed, millis: [" + sl::support::to_string(elapsed) + "]");
+}
+
+} // namespace
+
+class duktape_teardown::impl : public sl::pimpl::object::impl {
+    bool background;
+    uint32_t max_pending;
+    bool skip_at_exit;
+    // shared with pending tasks
+    std::shared_ptr<std::atomic<bool>> exiting;
+    std::shared_ptr<std::atomic<uint32_t>> pending;
+    std::atomic<uint64_t> offloaded;
+    std::atomic<uint64_t> in_place_finalizers;
+    std::atomic<uint64_t> in_place_queue_full;
+    // single thread, started on the first background teardown
+    duktape_worker_pool reaper;
+
+public:
+    impl(bool background, uint32_t max_pending, bool skip_at_exit) :
+    background(background),
+    max_pending(max_pending),
+    skip_at_exit(skip_at_exit),
+    exiting(std::make_shared<std::atomic<bool>>(false)),
+    pending(std::make_shared<std::atomic<uint32_t>>(0)),
+    offloaded(0),
+    in_place_finalizers(0),
+    in_place_queue_full(0),
+    reaper(1) { }
+
+    void destroy_heap(duktape_teardown&, duk_context* ctx, duktape_heap_dependencies dependencies,
+            bool has_finalizers) {
+        if (exiting->load(std::memory_order_acquire)) {
+            if (skip_at_exit) {
+                // memory is released by the OS
+                return;
+            }
+            // reaper thread may be already stopping
+            destroy_and_log(ctx);
+            return;
+        }
+        if (!background) {
+            destroy_and_log(ctx);
+            return;
+        }
+        // finalizers must not run on the reaper thread
+        if (has_finalizers) {
+            in_place_finalizers.fetch_add(1, std::memory_order_relaxed);
+            destroy_and_log(ctx);
+            return;
+        }
+        if (pending->fetch_add(1, std::memory_order_acq_rel) >= max_pending) {
+            pending->fetch_sub(1, std::memory_order_acq_rel);
+            in_place_queue_full.fetch_add(1, std::memory_order_relaxed);
+            destroy_and_log(ctx);
+            return;
+        }
+        offloaded.fetch_add(1, std::memory_order_relaxed);
+        auto deps = std::make_shared<duktape_heap_dependencies>(std::move(dependencies));
+        auto skip = skip_at_exit;
+        auto ex = exiting;
+        auto pend = pending;
+        reaper.submit([ctx, deps, skip, ex, pend] {
+            auto dec = sl::support::defer([pend]() STATICLIB_NOEXCEPT {
+                pend->fetch_sub(1, std::memory_order_acq_rel);
+            });
+            if (skip && ex->load(std::memory_order_acquire)) {
+                return;
+            }
+            destroy_and_log(ctx);
+            deps->clear();
+        });
+    }
+
+    sl::json::value stats(const duktape_teardown&) const {
+        return sl::json::value({
+            { "background", background },
+            { "maxPending", static_cast<int64_t> (max_pending) },
+            { "pending", static_cast<int64_t> (pending->load(std::memory_order_acquire)) },
+            { "offloaded", static_cast<int64_t> (offloaded.load(std::memory_order_relaxed)) },
+            { "inPlaceFinalizers", static_cast<int64_t> (in_place_finalizers.load(std::memory_order_relaxed)) },
+            { "inPlaceQueueFull", static_cast<int64_t> (in_place_queue_full.load(std::memory_order_relaxed)) }
+        });
+    }
+
+    void mark_process_exit(duktape_teardown&) {
+        exiting->store(true, std::memory_order_release);
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_teardown, (bool)(uint32_t)(bool), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_teardown, void, destroy_heap, (duk_context*)(duktape_heap_dependencies)(bool), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_teardown, void, mark_process_exit, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_teardown, sl::json::value, stats, (), (const), support::exception)
+
+std::shared_ptr<duktape_teardown> shared_teardown() {
+    static auto teardown = [] {
+        auto cf = load_duktape_config();
+        auto& tc = cf["teardown"];
+        return std::make_shared<duktape_teardown>(tc["background"].as_bool(false),
+                tc["maxPending"].as_uint32(16), tc["skipAtExit"].as_bool(false));
+    } ();
+    return teardown;
+}
+
+} // namespace
+}
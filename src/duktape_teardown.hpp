@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_teardown.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:30 PM
+ */
+
+#ifndef WILTON_DUKTAPE_TEARDOWN_HPP
+#define WILTON_DUKTAPE_TEARDOWN_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "duktape.h"
+
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Objects referenced from the heap (allocator udata, stash pointers),
+ * that must stay alive until the heap is destroyed
+ */
+typedef std::vector<std::shared_ptr<void>> duktape_heap_dependencies;
+
+/**
+ * Destroys engine heaps, either in place or on a background thread,
+ * heaps, that are released during process exit, can be left to the OS.
+ *
+ * Heaps with JS finalizers are always destroyed in place, finalizers
+ * may call native functions, that rely on the owner thread state.
+ */
+class duktape_teardown : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_teardown)
+
+    /**
+     * Finalizers are not run for heaps skipped at exit
+     *
+     * @param background destroy heaps on a background thread
+     * @param max_pending max number of heaps queued for background
+     *        destruction, heaps over this limit are destroyed in place
+     * @param skip_at_exit do not destroy heaps after process exit started
+     */
+    duktape_teardown(bool background, uint32_t max_pending, bool skip_at_exit);
+
+    /**
+     * @param ctx heap to destroy
+     * @param dependencies objects to release after the heap is destroyed
+     * @param has_finalizers whether JS finalizers were registered in this heap
+     */
+    void destroy_heap(duk_context* ctx, duktape_heap_dependencies dependencies, bool has_finalizers);
+
+    sl::json::value stats() const;
+
+    /**
+     * Called from "atexit" handler, that runs before
+     * the engines map is destroyed
+     */
+    void mark_process_exit();
+};
+
+// initialized from wilton_module_init before the engines map
+std::shared_ptr<duktape_teardown> shared_teardown();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_TEARDOWN_HPP */
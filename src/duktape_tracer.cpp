@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_tracer.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:30 AM
+ */
+
+#include "duktape_tracer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/logging.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const std::string logger = std::string("wilton.engine.duktape.trace");
+const size_t max_name_len = 63;
+const uint32_t max_buffer_size = 1 << 20;
+
+// checked by spans before touching the shared tracer instance
+std::atomic<bool> tracing_enabled(false);
+
+int64_t current_time_micros() {
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+}
+
+// fixed size to keep memory overhead independent of span names
+class trace_event {
+public:
+    char name[max_name_len + 1];
+    const char* category;
+    uint64_t thread_id;
+    int64_t start_micros;
+    int64_t duration_micros;
+    int64_t input_len;
+    int64_t output_len;
+};
+
+} // namespace
+
+class duktape_tracer::impl : public sl::pimpl::object::impl {
+    std::atomic<bool> enabled;
+    mutable std::mutex mutex;
+    std::vector<trace_event> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+public:
+    impl() {
+        enabled.store(false, std::memory_order_release);
+    }
+
+    void start(duktape_tracer&, uint32_t buffer_size) {
+        if (0 == buffer_size) throw support::exception(TRACEMSG(
+                "Invalid zero trace buffer size specified"));
+        if (buffer_size > max_buffer_size) {
+            wilton::support::log_warn(logger, "Trace buffer size: [" + sl::support::to_string(buffer_size) + "]" +
+                    " exceeds limit, using: [" + sl::support::to_string(max_buffer_size) + "]");
+            buffer_size = max_buffer_size;
+        }
+        std::lock_guard<std::mutex> guard{mutex};
+        ring.clear();
+        ring.shrink_to_fit();
+        ring.resize(buffer_size);
+        head = 0;
+        count = 0;
+        enabled.store(true, std::memory_order_release);
+        tracing_enabled.store(true, std::memory_order_relaxed);
+        wilton::support::log_info(logger, "Tracing started, buffer size: [" +
+                sl::support::to_string(buffer_size) + "]");
+    }
+
+    void stop(duktape_tracer&) {
+        enabled.store(false, std::memory_order_release);
+        tracing_enabled.store(false, std::memory_order_relaxed);
+        wilton::support::log_info(logger, "Tracing stopped");
+    }
+
+    bool is_enabled(const duktape_tracer&) const {
+        return enabled.load(std::memory_order_acquire);
+    }
+
+    void record(duktape_tracer&, const char* category, const char* name, size_t name_len,
+            int64_t start_micros, int64_t duration_micros, int64_t input_len, int64_t output_len) {
+        if (!enabled.load(std::memory_order_acquire)) {
+            return;
+        }
+        auto tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+        std::lock_guard<std::mutex> guard{mutex};
+        if (ring.empty()) {
+            return;
+        }
+        auto& ev = ring[head];
+        auto len = name_len < max_name_len ? name_len : max_name_len;
+        std::memcpy(ev.name, name, len);
+        ev.name[len] = '\0';
+        ev.category = category;
+        ev.thread_id = static_cast<uint64_t> (tid);
+        ev.start_micros = start_micros;
+        ev.duration_micros = duration_micros;
+        ev.input_len = input_len;
+        ev.output_len = output_len;
+        head = (head + 1) % ring.size();
+        if (count < ring.size()) {
+            count += 1;
+        }
+    }
+
+    sl::json::value dump(const duktape_tracer&) const {
+        auto events = std::vector<sl::json::value>();
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            size_t first = (head + ring.size() - count) % (ring.empty() ? 1 : ring.size());
+            for (size_t i = 0; i < count; i++) {
+                auto& ev = ring[(first + i) % ring.size()];
+                events.emplace_back(sl::json::value({
+                    { "name", std::string(ev.name) },
+                    { "cat", std::string(ev.category) },
+                    { "ph", "X" },
+                    { "ts", ev.start_micros },
+                    { "dur", ev.duration_micros },
+                    { "pid", 0 },
+                    { "tid", static_cast<int64_t> (ev.thread_id) },
+                    { "args", sl::json::value({
+                            { "inputLength", ev.input_len },
+                            { "outputLength", ev.output_len }
+                        })
+                    }
+                }));
+            }
+        }
+        return sl::json::value({
+            { "traceEvents", std::move(events) },
+            { "displayTimeUnit", "ms" }
+        });
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_tracer, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_tracer, void, start, (uint32_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_tracer, void, stop, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_tracer, bool, is_enabled, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_tracer, void, record, (const char*)(const char*)(size_t)(int64_t)(int64_t)(int64_t)(int64_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_tracer, sl::json::value, dump, (), (const), support::exception)
+
+std::shared_ptr<duktape_tracer> shared_tracer() {
+    static auto tracer = std::make_shared<duktape_tracer>();
+    return tracer;
+}
+
+duktape_trace_span::duktape_trace_span(const char* category, const char* name, size_t name_len, size_t input_len) :
+category(nullptr),
+start_micros(0),
+input_len(static_cast<int64_t> (input_len)),
+output_len(0) {
+    if (tracing_enabled.load(std::memory_order_relaxed) && shared_tracer()->is_enabled()) {
+        this->category = category;
+        this->name = std::string(name, name_len);
+        this->start_micros = current_time_micros();
+    }
+}
+
+duktape_trace_span::~duktape_trace_span() STATICLIB_NOEXCEPT {
+    if (nullptr == category) {
+        return;
+    }
+    try {
+        auto duration = current_time_micros() - start_micros;
+        shared_tracer()->record(category, name.c_str(), name.length(),
+                start_micros, duration, input_len, output_len);
+    } catch (...) {
+        // must not throw from destructor
+    }
+}
+
+void duktape_trace_span::set_output_len(size_t len) {
+    this->output_len = static_cast<int64_t> (len);
+}
+
+} // namespace
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_tracer.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:30 AM
+ */
+
+#ifndef WILTON_DUKTAPE_TRACER_HPP
+#define WILTON_DUKTAPE_TRACER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Fixed-size ring buffer of engine activity spans,
+ * that can be exported in Chrome trace-event format
+ */
+class duktape_tracer : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_tracer)
+
+    duktape_tracer();
+
+    void start(uint32_t buffer_size);
+
+    void stop();
+
+    bool is_enabled() const;
+
+    void record(const char* category, const char* name, size_t name_len,
+            int64_t start_micros, int64_t duration_micros, int64_t input_len, int64_t output_len);
+
+    sl::json::value dump() const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_tracer> shared_tracer();
+
+/**
+ * Records a span on destruction when tracing is enabled,
+ * does nothing otherwise
+ */
+class duktape_trace_span {
+    const char* category;
+    std::string name;
+    int64_t start_micros;
+    int64_t input_len;
+    int64_t output_len;
+
+public:
+    duktape_trace_span(const char* category, const char* name, size_t name_len, size_t input_len);
+
+    duktape_trace_span(const duktape_trace_span&) = delete;
+
+    duktape_trace_span& operator=(const duktape_trace_span&) = delete;
+
+    ~duktape_trace_span() STATICLIB_NOEXCEPT;
+
+    void set_output_len(size_t len);
+};
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_TRACER_HPP */
+
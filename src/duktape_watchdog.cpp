@@ -0,0 +1,257 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_watchdog.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 8:20 PM
+ */
+
+#include "duktape_watchdog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/logging.hpp"
+
+#include "duktape_config.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const std::string logger = std::string("wilton.engine.duktape.watchdog");
+const uint64_t default_check_interval_millis = 1000;
+const uint32_t default_summary_len = 256;
+
+uint64_t current_time_millis() {
+    auto now = std::chrono::steady_clock::now();
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count());
+}
+
+// largest prefix length, that does not cut UTF-8 sequence
+size_t utf8_prefix_len(sl::io::span<const char> data, size_t max_len) {
+    if (data.size() <= max_len) {
+        return data.size();
+    }
+    auto len = max_len;
+    // step back over continuation bytes to the sequence lead byte
+    while (len > 0 && 0x80 == (static_cast<unsigned char> (data.data()[len]) & 0xc0)) {
+        len -= 1;
+    }
+    return len;
+}
+
+} // namespace
+
+duktape_watched_engine::duktape_watched_engine(const std::string& thread_id) :
+thread_id(thread_id),
+call_started_millis(0),
+capture_requested(false),
+abort_requested(false) { }
+
+void duktape_watched_engine::begin_call(sl::io::span<const char> callback_script_json, size_t summary_len) {
+    {
+        std::lock_guard<std::mutex> guard{mutex};
+        call_summary.assign(callback_script_json.data(), utf8_prefix_len(callback_script_json, summary_len));
+        captured_stack.clear();
+        reported = false;
+    }
+    capture_requested.store(false, std::memory_order_relaxed);
+    abort_requested.store(false, std::memory_order_relaxed);
+    call_started_millis.store(current_time_millis(), std::memory_order_release);
+}
+
+void duktape_watched_engine::end_call() {
+    call_started_millis.store(0, std::memory_order_release);
+}
+
+void duktape_watched_engine::set_captured_stack(std::string stack) {
+    std::lock_guard<std::mutex> guard{mutex};
+    captured_stack = std::move(stack);
+    wilton::support::log_warn(logger, "Stuck call JS stack, thread: [" + thread_id + "]," +
+            " stack: [" + captured_stack + "]");
+}
+
+std::string duktape_watched_engine::report_once() {
+    std::lock_guard<std::mutex> guard{mutex};
+    if (reported) {
+        return std::string();
+    }
+    reported = true;
+    return call_summary;
+}
+
+sl::json::value duktape_watched_engine::to_json(uint64_t now_millis) {
+    auto started = call_started_millis.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> guard{mutex};
+    return sl::json::value({
+        { "threadId", thread_id },
+        { "durationMillis", static_cast<int64_t> (now_millis > started ? now_millis - started : 0) },
+        { "summary", call_summary },
+        { "stack", captured_stack },
+        { "abortRequested", abort_requested.load(std::memory_order_relaxed) }
+    });
+}
+
+class duktape_watchdog::impl : public sl::pimpl::object::impl {
+    uint64_t threshold_millis;
+    uint64_t abort_millis;
+    uint64_t check_interval_millis;
+    uint32_t summary_len;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    mutable std::vector<std::weak_ptr<duktape_watched_engine>> engines;
+    std::thread checker;
+    bool stopping = false;
+
+public:
+    impl(uint64_t threshold_millis, uint64_t abort_millis, uint64_t check_interval_millis, uint32_t summary_len) :
+    threshold_millis(threshold_millis),
+    abort_millis(abort_millis),
+    check_interval_millis(check_interval_millis > 0 ? check_interval_millis : default_check_interval_millis),
+    summary_len(summary_len) { }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            stopping = true;
+        }
+        cv.notify_all();
+        if (checker.joinable()) {
+            checker.join();
+        }
+    }
+
+    std::shared_ptr<duktape_watched_engine> register_engine(duktape_watchdog&) {
+        auto tid = sl::support::to_string_any(std::this_thread::get_id());
+        auto res = std::make_shared<duktape_watched_engine>(tid);
+        std::lock_guard<std::mutex> guard{mutex};
+        prune_engines();
+        engines.emplace_back(res);
+        if (threshold_millis > 0 && !checker.joinable()) {
+            checker = std::thread([this] {
+                run_checker();
+            });
+        }
+        return res;
+    }
+
+    uint32_t summary_length(const duktape_watchdog&) const {
+        return summary_len;
+    }
+
+    sl::json::value stuck_calls(const duktape_watchdog&, uint64_t min_duration_millis) const {
+        auto now = current_time_millis();
+        auto vec = std::vector<sl::json::value>();
+        for (auto& en : list_engines()) {
+            auto started = en->call_started_millis.load(std::memory_order_acquire);
+            if (0 != started && now - std::min(now, started) >= min_duration_millis) {
+                vec.emplace_back(en->to_json(now));
+            }
+        }
+        return sl::json::value(std::move(vec));
+    }
+
+private:
+    void run_checker() {
+        std::unique_lock<std::mutex> guard{mutex};
+        while (!stopping) {
+            cv.wait_for(guard, std::chrono::milliseconds(check_interval_millis));
+            if (stopping) {
+                break;
+            }
+            guard.unlock();
+            check_engines();
+            guard.lock();
+        }
+    }
+
+    void check_engines() {
+        auto now = current_time_millis();
+        for (auto& en : list_engines()) {
+            auto started = en->call_started_millis.load(std::memory_order_acquire);
+            if (0 == started || now < started) {
+                continue;
+            }
+            auto duration = now - started;
+            if (duration >= threshold_millis) {
+                auto summary = en->report_once();
+                if (!summary.empty()) {
+                    wilton::support::log_warn(logger, "Stuck call detected, thread: [" + en->thread_id + "]," +
+                            " running for: [" + sl::support::to_string(duration) + "] ms," +
+                            " callback: [" + summary + "]");
+                    en->capture_requested.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (abort_millis > 0 && duration >= abort_millis && !en->abort_requested.load(std::memory_order_relaxed)) {
+                wilton::support::log_warn(logger, "Requesting stuck call abort, thread: [" + en->thread_id + "]");
+                en->abort_requested.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<duktape_watched_engine>> list_engines() const {
+        auto res = std::vector<std::shared_ptr<duktape_watched_engine>>();
+        std::lock_guard<std::mutex> guard{mutex};
+        prune_engines();
+        for (auto& weak : engines) {
+            auto en = weak.lock();
+            if (nullptr != en.get()) {
+                res.emplace_back(std::move(en));
+            }
+        }
+        return res;
+    }
+
+    void prune_engines() const {
+        auto it = std::remove_if(engines.begin(), engines.end(), [](const std::weak_ptr<duktape_watched_engine>& weak) {
+            return weak.expired();
+        });
+        engines.erase(it, engines.end());
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_watchdog, (uint64_t)(uint64_t)(uint64_t)(uint32_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_watchdog, std::shared_ptr<duktape_watched_engine>, register_engine, (), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_watchdog, uint32_t, summary_length, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_watchdog, sl::json::value, stuck_calls, (uint64_t), (const), support::exception)
+
+std::shared_ptr<duktape_watchdog> shared_watchdog() {
+    static auto watchdog = [] {
+        auto cf = load_duktape_config();
+        auto& wc = cf["watchdog"];
+        return std::make_shared<duktape_watchdog>(
+                static_cast<uint64_t> (wc["thresholdMillis"].as_int64(0)),
+                static_cast<uint64_t> (wc["abortMillis"].as_int64(0)),
+                static_cast<uint64_t> (wc["checkIntervalMillis"].as_int64(static_cast<int64_t> (default_check_interval_millis))),
+                wc["summaryLength"].as_uint32(default_summary_len));
+    } ();
+    return watchdog;
+}
+
+} // namespace
+}
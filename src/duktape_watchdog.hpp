@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_watchdog.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 8:20 PM
+ */
+
+#ifndef WILTON_DUKTAPE_WATCHDOG_HPP
+#define WILTON_DUKTAPE_WATCHDOG_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * In-flight call state of a single engine, updated by the engine thread
+ * and inspected by the watchdog thread
+ */
+class duktape_watched_engine {
+    std::mutex mutex;
+    std::string call_summary;
+    std::string captured_stack;
+    bool reported = false;
+
+public:
+    const std::string thread_id;
+    // zero when engine is idle
+    std::atomic<uint64_t> call_started_millis;
+    std::atomic<bool> capture_requested;
+    std::atomic<bool> abort_requested;
+
+    duktape_watched_engine(const std::string& thread_id);
+
+    duktape_watched_engine(const duktape_watched_engine&) = delete;
+
+    duktape_watched_engine& operator=(const duktape_watched_engine&) = delete;
+
+    void begin_call(sl::io::span<const char> callback_script_json, size_t summary_len);
+
+    void end_call();
+
+    void set_captured_stack(std::string stack);
+
+    /**
+     * Marks the call as reported
+     *
+     * @return call summary, empty if call was already reported
+     */
+    std::string report_once();
+
+    sl::json::value to_json(uint64_t now_millis);
+};
+
+/**
+ * Watchdog thread checks in-flight calls of all engines, calls running
+ * longer than threshold are logged and their JS stacks are captured
+ * at the next native call boundary, optionally calls are aborted there,
+ * in the performance build pure JS code is also aborted by the executor
+ */
+class duktape_watchdog : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_watchdog)
+
+    /**
+     * Watchdog thread is not started if threshold is zero,
+     * calls are not aborted if abort threshold is zero
+     */
+    duktape_watchdog(uint64_t threshold_millis, uint64_t abort_millis,
+            uint64_t check_interval_millis, uint32_t summary_len);
+
+    std::shared_ptr<duktape_watched_engine> register_engine();
+
+    uint32_t summary_length() const;
+
+    /**
+     * @param min_duration_millis calls running shorter than this are skipped
+     * @return in-flight calls JSON
+     */
+    sl::json::value stuck_calls(uint64_t min_duration_millis) const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_watchdog> shared_watchdog();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_WATCHDOG_HPP */
+
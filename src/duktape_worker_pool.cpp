@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_worker_pool.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:40 PM
+ */
+
+#include "duktape_worker_pool.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "staticlib/pimpl/forward_macros.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/logging.hpp"
+
+#include "duktape_config.hpp"
+
+namespace wilton {
+namespace duktape {
+
+namespace { // anonymous
+
+const uint32_t default_threads_count = 4;
+
+} // namespace
+
+class duktape_worker_pool::impl : public sl::pimpl::object::impl {
+    uint32_t max_threads;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+public:
+    impl(uint32_t threads_count) :
+    max_threads(threads_count > 0 ? threads_count : default_threads_count) { }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+
+    void submit(duktape_worker_pool&, std::function<void()> task) {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (stopping) throw support::exception(TRACEMSG(
+                "Worker pool is stopped"));
+        if (threads.empty()) {
+            for (uint32_t i = 0; i < max_threads; i++) {
+                threads.emplace_back(std::thread([this] {
+                    run_worker();
+                }));
+            }
+        }
+        tasks.emplace_back(std::move(task));
+        cv.notify_one();
+    }
+
+    uint32_t threads_count(const duktape_worker_pool&) const {
+        return max_threads;
+    }
+
+    bool is_worker_thread(const duktape_worker_pool&) const {
+        auto tid = std::this_thread::get_id();
+        std::lock_guard<std::mutex> guard{mutex};
+        for (auto& th : threads) {
+            if (tid == th.get_id()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    void run_worker() {
+        for (;;) {
+            auto task = std::function<void()>();
+            {
+                std::unique_lock<std::mutex> guard{mutex};
+                cv.wait(guard, [this] {
+                    return stopping || !tasks.empty();
+                });
+                if (tasks.empty()) {
+                    // stopping
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            try {
+                task();
+            } catch (const std::exception& e) {
+                wilton::support::log_error("wilton.engine.duktape.pool",
+                        TRACEMSG(e.what() + "\nWorker task error"));
+            } catch (...) {
+                wilton::support::log_error("wilton.engine.duktape.pool",
+                        TRACEMSG("Worker task error"));
+            }
+        }
+    }
+};
+
+PIMPL_FORWARD_CONSTRUCTOR(duktape_worker_pool, (uint32_t), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_worker_pool, void, submit, (std::function<void()>), (), support::exception)
+PIMPL_FORWARD_METHOD(duktape_worker_pool, uint32_t, threads_count, (), (const), support::exception)
+PIMPL_FORWARD_METHOD(duktape_worker_pool, bool, is_worker_thread, (), (const), support::exception)
+
+std::shared_ptr<duktape_worker_pool> shared_worker_pool() {
+    static auto pool = [] {
+        auto cf = load_duktape_config();
+        auto threads_count = cf["workerPool"]["threads"].as_uint32(
+                static_cast<uint32_t> (std::thread::hardware_concurrency()));
+        return std::make_shared<duktape_worker_pool>(threads_count);
+    } ();
+    return pool;
+}
+
+} // namespace
+}
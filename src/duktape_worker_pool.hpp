@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   duktape_worker_pool.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 5:40 PM
+ */
+
+#ifndef WILTON_DUKTAPE_WORKER_POOL_HPP
+#define WILTON_DUKTAPE_WORKER_POOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "staticlib/pimpl.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace duktape {
+
+/**
+ * Fixed-size pool of native threads, threads are started
+ * on the first submitted task
+ */
+class duktape_worker_pool : public sl::pimpl::object {
+protected:
+    /**
+     * implementation class
+     */
+    class impl;
+
+public:
+    /**
+     * PIMPL-specific constructor
+     *
+     * @param pimpl impl object
+     */
+    PIMPL_CONSTRUCTOR(duktape_worker_pool)
+
+    duktape_worker_pool(uint32_t threads_count);
+
+    /**
+     * Task must not throw, exceptions are logged and discarded
+     *
+     * @param task task to run on one of the pool threads
+     */
+    void submit(std::function<void()> task);
+
+    uint32_t threads_count() const;
+
+    /**
+     * Tasks, that wait for other pool tasks, must not run on
+     * pool threads to avoid exhausting the pool
+     *
+     * @return true if called from one of the pool threads
+     */
+    bool is_worker_thread() const;
+};
+
+// initialized from wilton_module_init
+std::shared_ptr<duktape_worker_pool> shared_worker_pool();
+
+} // namespace
+}
+
+#endif /* WILTON_DUKTAPE_WORKER_POOL_HPP */
+
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* 
+ * File:   wilton_duktape.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:40 AM
+ */
+
+#include "wilton/wilton_duktape.h"
+
+#include <string>
+
+#include "staticlib/support.hpp"
+
+#include "wilton/wiltoncall.h"
+
+#include "wilton/support/exception.hpp"
+
+#include "duktape_function_registry.hpp"
+#include "duktape_prepared_handlers.hpp"
+#include "duktape_stream_registry.hpp"
+
+char* wilton_duktape_register_sink(const char* sink_name, int sink_name_len, void* sink_ctx,
+        char* (*write_cb)(void* sink_ctx, const char* data, int data_len)) /* noexcept */ {
+    if (nullptr == sink_name) return wilton::support::alloc_copy(TRACEMSG("Null 'sink_name' parameter specified"));
+    if (sink_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'sink_name_len' parameter specified: [" + sl::support::to_string(sink_name_len) + "]"));
+    if (nullptr == write_cb) return wilton::support::alloc_copy(TRACEMSG("Null 'write_cb' parameter specified"));
+    try {
+        auto name = std::string(sink_name, static_cast<size_t> (sink_name_len));
+        auto registry = wilton::duktape::shared_stream_registry();
+        registry->register_sink(name, sink_ctx, write_cb);
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_unregister_sink(const char* sink_name, int sink_name_len) /* noexcept */ {
+    if (nullptr == sink_name) return wilton::support::alloc_copy(TRACEMSG("Null 'sink_name' parameter specified"));
+    if (sink_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'sink_name_len' parameter specified: [" + sl::support::to_string(sink_name_len) + "]"));
+    try {
+        auto name = std::string(sink_name, static_cast<size_t> (sink_name_len));
+        auto registry = wilton::duktape::shared_stream_registry();
+        registry->unregister_sink(name);
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_register_source(const char* source_name, int source_name_len, void* source_ctx,
+        char* (*read_cb)(void* source_ctx, char* buffer, int buffer_len, int* read_out)) /* noexcept */ {
+    if (nullptr == source_name) return wilton::support::alloc_copy(TRACEMSG("Null 'source_name' parameter specified"));
+    if (source_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'source_name_len' parameter specified: [" + sl::support::to_string(source_name_len) + "]"));
+    if (nullptr == read_cb) return wilton::support::alloc_copy(TRACEMSG("Null 'read_cb' parameter specified"));
+    try {
+        auto name = std::string(source_name, static_cast<size_t> (source_name_len));
+        auto registry = wilton::duktape::shared_stream_registry();
+        registry->register_source(name, source_ctx, read_cb);
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_register_memory_source(const char* source_name, int source_name_len,
+        const char* data, int data_len) /* noexcept */ {
+    if (nullptr == source_name) return wilton::support::alloc_copy(TRACEMSG("Null 'source_name' parameter specified"));
+    if (source_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'source_name_len' parameter specified: [" + sl::support::to_string(source_name_len) + "]"));
+    if (nullptr == data && 0 != data_len) return wilton::support::alloc_copy(TRACEMSG("Null 'data' parameter specified"));
+    if (data_len < 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'data_len' parameter specified: [" + sl::support::to_string(data_len) + "]"));
+    try {
+        auto name = std::string(source_name, static_cast<size_t> (source_name_len));
+        auto registry = wilton::duktape::shared_stream_registry();
+        registry->register_memory_source(name, {data, static_cast<size_t> (data_len)});
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_unregister_source(const char* source_name, int source_name_len) /* noexcept */ {
+    if (nullptr == source_name) return wilton::support::alloc_copy(TRACEMSG("Null 'source_name' parameter specified"));
+    if (source_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'source_name_len' parameter specified: [" + sl::support::to_string(source_name_len) + "]"));
+    try {
+        auto name = std::string(source_name, static_cast<size_t> (source_name_len));
+        auto registry = wilton::duktape::shared_stream_registry();
+        registry->unregister_source(name);
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_register_function(const char* fun_name, int fun_name_len, void* fun_ctx,
+        char* (*fun_cb)(void* fun_ctx, const wilton_DuktapeValue* args, int args_count,
+                wilton_DuktapeValue* result_out)) /* noexcept */ {
+    if (nullptr == fun_name) return wilton::support::alloc_copy(TRACEMSG("Null 'fun_name' parameter specified"));
+    if (fun_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'fun_name_len' parameter specified: [" + sl::support::to_string(fun_name_len) + "]"));
+    if (nullptr == fun_cb) return wilton::support::alloc_copy(TRACEMSG("Null 'fun_cb' parameter specified"));
+    try {
+        auto name = std::string(fun_name, static_cast<size_t> (fun_name_len));
+        auto registry = wilton::duktape::shared_function_registry();
+        registry->register_function(name, fun_ctx, fun_cb);
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_prepare_handler(const char* module_name, int module_name_len,
+        const char* func_name, int func_name_len, int* handle_out) /* noexcept */ {
+    if (nullptr == module_name) return wilton::support::alloc_copy(TRACEMSG("Null 'module_name' parameter specified"));
+    if (module_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'module_name_len' parameter specified: [" + sl::support::to_string(module_name_len) + "]"));
+    if (nullptr == func_name) return wilton::support::alloc_copy(TRACEMSG("Null 'func_name' parameter specified"));
+    if (func_name_len <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'func_name_len' parameter specified: [" + sl::support::to_string(func_name_len) + "]"));
+    if (nullptr == handle_out) return wilton::support::alloc_copy(TRACEMSG("Null 'handle_out' parameter specified"));
+    try {
+        auto module = std::string(module_name, static_cast<size_t> (module_name_len));
+        auto func = std::string(func_name, static_cast<size_t> (func_name_len));
+        auto handlers = wilton::duktape::shared_prepared_handlers();
+        auto handle = handlers->prepare(module, func);
+        *handle_out = static_cast<int> (handle);
+        return nullptr;
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
+
+char* wilton_duktape_invoke_handler(int handle, const char* args, int args_len,
+        char** result_out, int* result_len_out) /* noexcept */ {
+    if (handle <= 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'handle' parameter specified: [" + sl::support::to_string(handle) + "]"));
+    if (nullptr == args && 0 != args_len) return wilton::support::alloc_copy(TRACEMSG("Null 'args' parameter specified"));
+    if (args_len < 0) return wilton::support::alloc_copy(TRACEMSG(
+            "Invalid 'args_len' parameter specified: [" + sl::support::to_string(args_len) + "]"));
+    if (nullptr == result_out) return wilton::support::alloc_copy(TRACEMSG("Null 'result_out' parameter specified"));
+    if (nullptr == result_len_out) return wilton::support::alloc_copy(TRACEMSG("Null 'result_len_out' parameter specified"));
+    try {
+        auto payload = wilton::duktape::make_invoke_payload(static_cast<uint64_t> (handle),
+                {args, static_cast<size_t> (args_len)});
+        // same path as callback scripts, engine is selected by the engines map
+        auto name = std::string("runscript_duktape");
+        return wiltoncall(name.c_str(), static_cast<int> (name.length()),
+                payload.data(), static_cast<int> (payload.length()), result_out, result_len_out);
+    } catch (const std::exception& e) {
+        return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));
+    }
+}
@@ -21,11 +21,13 @@
  * Created on May 20, 2017, 1:17 PM
  */
 
+#include <cstdlib>
 #include <memory>
 #include <string>
 
 #include "staticlib/config.hpp"
 #include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
 
 #include "wilton/wilton.h"
 
@@ -34,7 +36,23 @@
 #include "wilton/support/registrar.hpp"
 #include "wilton/support/script_engine_map.hpp"
 
+#include "duktape_async_calls.hpp"
+#include "duktape_callback_info.hpp"
+#include "duktape_channel_registry.hpp"
+#include "duktape_cost_tracker.hpp"
 #include "duktape_engine.hpp"
+#include "duktape_function_registry.hpp"
+#include "duktape_memoizer.hpp"
+#include "duktape_placement.hpp"
+#include "duktape_prepared_handlers.hpp"
+#include "duktape_scheduler.hpp"
+#include "duktape_shared_cache.hpp"
+#include "duktape_source_loader.hpp"
+#include "duktape_stream_registry.hpp"
+#include "duktape_teardown.hpp"
+#include "duktape_tracer.hpp"
+#include "duktape_watchdog.hpp"
+#include "duktape_worker_pool.hpp"
 
 namespace wilton {
 namespace duktape {
@@ -47,7 +65,43 @@ std::shared_ptr<support::script_engine_map<duktape_engine>> shared_tlmap() {
 
 support::buffer runscript(sl::io::span<const char> data) {
     auto tlmap = shared_tlmap();
-    return tlmap->run_script(data);
+    // prepared handler invocations carry no callback JSON to memoize or prioritize
+    if (is_invoke_payload(data)) {
+        return tlmap->run_script(data);
+    }
+    auto scheduler = shared_scheduler();
+    auto memoizer = shared_memoizer();
+    auto costs_enabled = shared_cost_tracker()->is_enabled();
+    if (!(scheduler->is_enabled() || memoizer->is_enabled() || costs_enabled)) {
+        return tlmap->run_script(data);
+    }
+    // header fields are read once for all the consumers, "args" are not parsed
+    auto info = read_callback_info(data);
+    duktape_callback_info_scope info_scope(costs_enabled ? std::addressof(info) : nullptr);
+    // memoized results are returned without waiting for the scheduler
+    auto run = [&tlmap, &scheduler, &info](sl::io::span<const char> script) {
+        if (scheduler->is_enabled()) {
+            return scheduler->run_script(info, script, [&tlmap](sl::io::span<const char> sc) {
+                return tlmap->run_script(sc);
+            });
+        }
+        return tlmap->run_script(script);
+    };
+    if (memoizer->is_enabled()) {
+        return memoizer->run_script(info, data, run);
+    }
+    return run(data);
+}
+
+support::buffer prepare(sl::io::span<const char> data) {
+    auto json = sl::json::load(data);
+    auto& module = json["module"].as_string_nonempty_or_throw("module");
+    auto& func = json["func"].as_string_nonempty_or_throw("func");
+    auto handlers = shared_prepared_handlers();
+    auto handle = handlers->prepare(module, func);
+    return support::make_json_buffer(sl::json::value({
+        { "handle", static_cast<int64_t> (handle) }
+    }));
 }
 
 support::buffer rungc(sl::io::span<const char>) {
@@ -56,6 +110,92 @@ support::buffer rungc(sl::io::span<const char>) {
     return support::make_null_buffer();
 }
 
+support::buffer heapstats(sl::io::span<const char> data) {
+    auto options = data.size() > 0 ? sl::json::load(data) : sl::json::value();
+    return support::make_json_buffer(run_heap_census(options));
+}
+
+support::buffer costs(sl::io::span<const char> data) {
+    auto options = data.size() > 0 ? sl::json::load(data) : sl::json::value();
+    auto tracker = shared_cost_tracker();
+    return support::make_json_buffer(tracker->top(options));
+}
+
+support::buffer memostats(sl::io::span<const char>) {
+    auto memoizer = shared_memoizer();
+    return support::make_json_buffer(memoizer->stats());
+}
+
+support::buffer memoinvalidate(sl::io::span<const char> data) {
+    auto json = data.size() > 0 ? sl::json::load(data) : sl::json::value();
+    auto memoizer = shared_memoizer();
+    auto count = memoizer->invalidate(json["module"].as_string(), json["func"].as_string());
+    return support::make_json_buffer(sl::json::value({
+        { "invalidated", static_cast<int64_t> (count) }
+    }));
+}
+
+support::buffer schedulerstats(sl::io::span<const char>) {
+    auto scheduler = shared_scheduler();
+    return support::make_json_buffer(scheduler->stats());
+}
+
+support::buffer stuckcalls(sl::io::span<const char> data) {
+    auto json = data.size() > 0 ? sl::json::load(data) : sl::json::value();
+    auto min_duration = json["minDurationMillis"].as_int64(0);
+    auto watchdog = shared_watchdog();
+    return support::make_json_buffer(watchdog->stuck_calls(static_cast<uint64_t> (min_duration)));
+}
+
+support::buffer tracestart(sl::io::span<const char> data) {
+    uint32_t buffer_size = 1 << 16;
+    if (data.size() > 0) {
+        auto json = sl::json::load(data);
+        buffer_size = json["bufferSize"].as_uint32(buffer_size);
+    }
+    auto tracer = shared_tracer();
+    tracer->start(buffer_size);
+    return support::make_null_buffer();
+}
+
+support::buffer tracestop(sl::io::span<const char>) {
+    auto tracer = shared_tracer();
+    tracer->stop();
+    return support::make_null_buffer();
+}
+
+support::buffer tracedump(sl::io::span<const char>) {
+    auto tracer = shared_tracer();
+    return support::make_json_buffer(tracer->dump());
+}
+
+support::buffer cachestats(sl::io::span<const char>) {
+    auto cache = shared_cache();
+    return support::make_json_buffer(cache->stats());
+}
+
+support::buffer cacheclear(sl::io::span<const char>) {
+    auto cache = shared_cache();
+    cache->clear();
+    return support::make_null_buffer();
+}
+
+support::buffer placement(sl::io::span<const char>) {
+    auto pl = shared_placement();
+    return support::make_json_buffer(pl->report());
+}
+
+support::buffer teardownstats(sl::io::span<const char>) {
+    auto teardown = shared_teardown();
+    return support::make_json_buffer(teardown->stats());
+}
+
+// registered after the engines map is created, so runs before it is destroyed
+void mark_process_exit() {
+    auto teardown = shared_teardown();
+    teardown->mark_process_exit();
+}
+
 void clean_tls(void*, const char* thread_id, int thread_id_len) {
     auto tlmap = shared_tlmap();
     tlmap->clean_thread_local(thread_id, thread_id_len);
@@ -66,11 +206,42 @@ void clean_tls(void*, const char* thread_id, int thread_id_len) {
 
 extern "C" char* wilton_module_init() {
     try {
+        // engines are destroyed using teardown, so it must outlive the engines map
+        wilton::duktape::shared_teardown();
         wilton::duktape::shared_tlmap();
+        wilton::duktape::shared_stream_registry();
+        wilton::duktape::shared_channel_registry();
+        wilton::duktape::shared_cache();
+        wilton::duktape::shared_cost_tracker();
+        wilton::duktape::shared_memoizer();
+        wilton::duktape::shared_placement();
+        wilton::duktape::shared_prepared_handlers();
+        wilton::duktape::shared_scheduler();
+        wilton::duktape::shared_source_loader();
+        wilton::duktape::shared_function_registry();
+        wilton::duktape::shared_tracer();
+        wilton::duktape::shared_watchdog();
+        wilton::duktape::shared_worker_pool();
+        wilton::duktape::shared_async_calls();
+        std::atexit(wilton::duktape::mark_process_exit);
         auto err = wilton_register_tls_cleaner(nullptr, wilton::duktape::clean_tls);
         if (nullptr != err) wilton::support::throw_wilton_error(err, TRACEMSG(err));
         wilton::support::register_wiltoncall("runscript_duktape", wilton::duktape::runscript);
+        wilton::support::register_wiltoncall("prepare_duktape", wilton::duktape::prepare);
         wilton::support::register_wiltoncall("rungc_duktape", wilton::duktape::rungc);
+        wilton::support::register_wiltoncall("heapstats_duktape", wilton::duktape::heapstats);
+        wilton::support::register_wiltoncall("costs_duktape", wilton::duktape::costs);
+        wilton::support::register_wiltoncall("stuckcalls_duktape", wilton::duktape::stuckcalls);
+        wilton::support::register_wiltoncall("tracestart_duktape", wilton::duktape::tracestart);
+        wilton::support::register_wiltoncall("tracestop_duktape", wilton::duktape::tracestop);
+        wilton::support::register_wiltoncall("tracedump_duktape", wilton::duktape::tracedump);
+        wilton::support::register_wiltoncall("cachestats_duktape", wilton::duktape::cachestats);
+        wilton::support::register_wiltoncall("cacheclear_duktape", wilton::duktape::cacheclear);
+        wilton::support::register_wiltoncall("memostats_duktape", wilton::duktape::memostats);
+        wilton::support::register_wiltoncall("memoinvalidate_duktape", wilton::duktape::memoinvalidate);
+        wilton::support::register_wiltoncall("placement_duktape", wilton::duktape::placement);
+        wilton::support::register_wiltoncall("schedulerstats_duktape", wilton::duktape::schedulerstats);
+        wilton::support::register_wiltoncall("teardownstats_duktape", wilton::duktape::teardownstats);
         return nullptr;
     } catch (const std::exception& e) {
         return wilton::support::alloc_copy(TRACEMSG(e.what() + "\nException raised"));